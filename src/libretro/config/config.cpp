@@ -55,6 +55,7 @@
 #include "config/constants.hpp"
 #include "config/definitions.hpp"
 #include "config/definitions/categories.hpp"
+#include "config/sysfiles.hpp"
 #include "../core/core.hpp"
 #include "embedded/melondsds_default_wfc_config.h"
 #include "environment.hpp"
@@ -95,6 +96,7 @@ const char* const DEFAULT_HOMEBREW_SDCARD_IMAGE_NAME = "dldi_sd_card.bin";
 const char* const DEFAULT_HOMEBREW_SDCARD_DIR_NAME = "dldi_sd_card";
 const char* const DEFAULT_DSI_SDCARD_IMAGE_NAME = "dsi_sd_card.bin";
 const char* const DEFAULT_DSI_SDCARD_DIR_NAME = "dsi_sd_card";
+const char* const SYSTEM_FILE_INDEX_NAME = "sysfiles.index";
 
 const initializer_list<unsigned> CURSOR_TIMEOUTS = {1, 2, 3, 5, 10, 15, 20, 30, 60};
 const initializer_list<unsigned> DS_POWER_OK_THRESHOLDS = {0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
@@ -110,6 +112,7 @@ namespace MelonDsDs::config {
     static void ParseTimeOptions(CoreConfig& config) noexcept;
     static void ParseOsdOptions(CoreConfig& config) noexcept;
     static void ParseJitOptions(CoreConfig& config) noexcept;
+    static void ParseThreadOptions(CoreConfig& config) noexcept;
     static void ParseHomebrewSaveOptions(CoreConfig& config) noexcept;
     static void ParseDsiStorageOptions(CoreConfig& config) noexcept;
     static void ParseFirmwareOptions(CoreConfig& config) noexcept;
@@ -151,6 +154,7 @@ void MelonDsDs::ParseConfig(CoreConfig& config) noexcept {
     config::ParseTimeOptions(config);
     config::ParseOsdOptions(config);
     config::ParseJitOptions(config);
+    config::ParseThreadOptions(config);
     config::ParseHomebrewSaveOptions(config);
     config::ParseDsiStorageOptions(config);
     config::ParseFirmwareOptions(config);
@@ -217,6 +221,38 @@ static void MelonDsDs::config::ParseSystemOptions(CoreConfig& config) noexcept {
         retro::warn("Failed to get value for {}; defaulting to 15 seconds", BATTERY_UPDATE_INTERVAL);
         config.SetPowerUpdateInterval(15);
     }
+
+    if (optional<unsigned> value = ParseIntegerInRange(get_variable(RUNAHEAD_FRAMES), 0u, MAX_RUNAHEAD_FRAMES)) {
+        config.SetRunAheadFrames(*value);
+    }
+    else {
+        retro::warn("Failed to get value for {}; defaulting to {}", RUNAHEAD_FRAMES, definitions::RunAheadFrames.default_value);
+        config.SetRunAheadFrames(0);
+    }
+
+    if (optional<bool> value = ParseBoolean(get_variable(LAZY_INPUT_POLLING))) {
+        config.SetLazyInputPolling(*value);
+    }
+    else {
+        retro::warn("Failed to get value for {}; defaulting to {}", LAZY_INPUT_POLLING, values::DISABLED);
+        config.SetLazyInputPolling(false);
+    }
+
+    if (optional<MovieMode> value = ParseMovieMode(get_variable(MOVIE_MODE))) {
+        config.SetMovieMode(*value);
+    }
+    else {
+        retro::warn("Failed to get value for {}; defaulting to {}", MOVIE_MODE, values::DISABLED);
+        config.SetMovieMode(MovieMode::Disabled);
+    }
+
+    if (optional<CaptureMode> value = ParseCaptureMode(get_variable(FRAME_CAPTURE))) {
+        config.SetCaptureMode(*value);
+    }
+    else {
+        retro::warn("Failed to get value for {}; defaulting to {}", FRAME_CAPTURE, values::DISABLED);
+        config.SetCaptureMode(CaptureMode::Disabled);
+    }
 }
 
 void MelonDsDs::config::ParseTimeOptions(CoreConfig& config) noexcept {
@@ -420,6 +456,25 @@ static void MelonDsDs::config::ParseJitOptions(CoreConfig& config) noexcept {
 #endif
 }
 
+static void MelonDsDs::config::ParseThreadOptions(CoreConfig& config) noexcept {
+    ZoneScopedN(TracyFunction);
+    using retro::get_variable;
+
+    if (optional<ThreadAffinity> value = ParseThreadAffinity(get_variable(cpu::THREAD_AFFINITY))) {
+        config.SetThreadAffinity(*value);
+    } else {
+        retro::warn("Failed to get value for {}; defaulting to {}", cpu::THREAD_AFFINITY, values::DEFAULT);
+        config.SetThreadAffinity(ThreadAffinity::Default);
+    }
+
+    if (optional<ThreadPriority> value = ParseThreadPriority(get_variable(cpu::THREAD_PRIORITY))) {
+        config.SetThreadPriority(*value);
+    } else {
+        retro::warn("Failed to get value for {}; defaulting to {}", cpu::THREAD_PRIORITY, values::DEFAULT);
+        config.SetThreadPriority(ThreadPriority::Default);
+    }
+}
+
 static void MelonDsDs::config::ParseHomebrewSaveOptions(CoreConfig& config) noexcept {
     ZoneScopedN(TracyFunction);
     using retro::get_variable;
@@ -838,12 +893,19 @@ static void MelonDsDs::config::ParseVideoOptions(CoreConfig& config) noexcept {
         retro::warn("Failed to get value for {}; defaulting to {}", OPENGL_BETTER_POLYGONS, values::DISABLED);
         config.SetBetterPolygonSplitting(false);
     }
+
+    if (optional<bool> value = ParseBoolean(get_variable(OPENGL_GPU_TIMING))) {
+        config.SetGpuTiming(*value);
+    } else {
+        retro::warn("Failed to get value for {}; defaulting to {}", OPENGL_GPU_TIMING, values::DISABLED);
+        config.SetGpuTiming(false);
+    }
 #endif
 }
 
 struct FirmwareEntry {
     std::string path;
-    Firmware::FirmwareHeader header;
+    Firmware::FirmwareConsoleType consoleType;
     struct stat stat;
 };
 
@@ -856,12 +918,12 @@ static time_t NewestTimestamp(const struct stat& statbuf) noexcept {
     return std::max({statbuf.st_atime, statbuf.st_mtime, statbuf.st_ctime});
 }
 
-static bool ConsoleTypeMatches(const Firmware::FirmwareHeader& header, MelonDsDs::ConsoleType type) noexcept {
+static bool ConsoleTypeMatches(Firmware::FirmwareConsoleType consoleType, MelonDsDs::ConsoleType type) noexcept {
     if (type == MelonDsDs::ConsoleType::DS) {
-        return header.ConsoleType == Firmware::FirmwareConsoleType::DS || header.ConsoleType == Firmware::FirmwareConsoleType::DSLite;
+        return consoleType == Firmware::FirmwareConsoleType::DS || consoleType == Firmware::FirmwareConsoleType::DSLite;
     }
     else {
-        return header.ConsoleType == Firmware::FirmwareConsoleType::DSi;
+        return consoleType == Firmware::FirmwareConsoleType::DSi;
     }
 }
 
@@ -872,8 +934,8 @@ static const char* SelectDefaultFirmware(const vector<FirmwareEntry>& images, Me
     optional<string_view> sysdir = retro::get_system_directory();
 
     const auto& best = std::max_element(images.begin(), images.end(), [type](const FirmwareEntry& a, const FirmwareEntry& b) {
-        bool aMatches = ConsoleTypeMatches(a.header, type);
-        bool bMatches = ConsoleTypeMatches(b.header, type);
+        bool aMatches = ConsoleTypeMatches(a.consoleType, type);
+        bool bMatches = ConsoleTypeMatches(b.consoleType, type);
 
         if (!aMatches && bMatches) {
             // If the second image matches but the first doesn't, the second is automatically better
@@ -923,9 +985,8 @@ bool MelonDsDs::RegisterCoreOptions() noexcept {
     if (subdir) {
         ZoneScopedN("MelonDsDs::config::set_core_options::find_system_files");
         retro_assert(sysdir.has_value());
-        u8 headerBytes[sizeof(Firmware::FirmwareHeader)];
-        Firmware::FirmwareHeader& header = *reinterpret_cast<Firmware::FirmwareHeader*>(headerBytes);
-        memset(headerBytes, 0, sizeof(headerBytes));
+        optional<string> indexPath = retro::get_save_subdir_path(SYSTEM_FILE_INDEX_NAME);
+        SystemFileIndex index(indexPath ? *indexPath : string());
         array paths = {*sysdir, *subdir};
         for (const string_view& path: paths) {
             ZoneScopedN("MelonDsDs::config::set_core_options::find_system_files::paths");
@@ -933,16 +994,25 @@ bool MelonDsDs::RegisterCoreOptions() noexcept {
                 ZoneScopedN("MelonDsDs::config::set_core_options::find_system_files::paths::dirent");
                 // TODO: Pick a particular file name and load MAC addresses from it (one per line)
 
-                if (IsDsiNandImage(d)) {
+                optional<SystemFile> file = index.Classify(d);
+                if (!file)
+                    continue;
+
+                if (file->Type == SystemFileType::DsiNand) {
                     dsiNandPaths.emplace_back(d.path);
-                } else if (IsFirmwareImage(d, header)) {
-                    struct stat statbuf;
-                    stat(d.path, &statbuf);
-                    firmware.emplace_back(FirmwareEntry {d.path, header, statbuf});
+                } else if (file->Type == SystemFileType::Firmware) {
+                    firmware.emplace_back(FirmwareEntry {d.path, file->ConsoleType, file->Stat});
                 }
             }
         }
 
+        if (indexPath) {
+            // No save directory means no index; we'll just scan everything again next time
+            index.Save();
+        }
+        SetSystemFileIndexStats(index.Stats());
+        retro::debug("Scanned the system directory ({} cached, {} inspected)", index.Stats().Hits, index.Stats().Misses);
+
     } else {
         retro::set_error_message("Failed to get system directory, anything that needs it won't work.");
     }
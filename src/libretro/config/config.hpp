@@ -149,6 +149,12 @@ namespace MelonDsDs {
 #   endif
 #endif
 
+        [[nodiscard]] MelonDsDs::ThreadAffinity ThreadAffinity() const noexcept { return _threadAffinity; }
+        void SetThreadAffinity(MelonDsDs::ThreadAffinity affinity) noexcept { _threadAffinity = affinity; }
+
+        [[nodiscard]] MelonDsDs::ThreadPriority ThreadPriority() const noexcept { return _threadPriority; }
+        void SetThreadPriority(MelonDsDs::ThreadPriority priority) noexcept { _threadPriority = priority; }
+
 #ifdef HAVE_NETWORKING
         [[nodiscard]] MelonDsDs::NetworkMode NetworkMode() const noexcept { return _networkMode; }
         void SetNetworkMode(MelonDsDs::NetworkMode mode) noexcept { _networkMode = mode; }
@@ -297,6 +303,18 @@ namespace MelonDsDs {
         [[nodiscard]] unsigned PowerUpdateInterval() const noexcept { return _powerUpdateInterval; }
         void SetPowerUpdateInterval(unsigned powerUpdateInterval) noexcept { _powerUpdateInterval = powerUpdateInterval; }
 
+        [[nodiscard]] unsigned RunAheadFrames() const noexcept { return _runAheadFrames; }
+        void SetRunAheadFrames(unsigned runAheadFrames) noexcept { _runAheadFrames = runAheadFrames; }
+
+        [[nodiscard]] bool LazyInputPolling() const noexcept { return _lazyInputPolling; }
+        void SetLazyInputPolling(bool lazyInputPolling) noexcept { _lazyInputPolling = lazyInputPolling; }
+
+        [[nodiscard]] MelonDsDs::MovieMode MovieMode() const noexcept { return _movieMode; }
+        void SetMovieMode(MelonDsDs::MovieMode movieMode) noexcept { _movieMode = movieMode; }
+
+        [[nodiscard]] MelonDsDs::CaptureMode CaptureMode() const noexcept { return _captureMode; }
+        void SetCaptureMode(MelonDsDs::CaptureMode captureMode) noexcept { _captureMode = captureMode; }
+
         // TODO: Allow these paths to be customized
         string_view Bios9Path() const noexcept { return "bios9.bin"; }
         string_view Bios7Path() const noexcept { return "bios7.bin"; }
@@ -328,6 +346,9 @@ namespace MelonDsDs {
         [[nodiscard]] bool BetterPolygonSplitting() const noexcept { return _betterPolygonSplitting; }
         void SetBetterPolygonSplitting(bool betterPolygonSplitting) noexcept { _betterPolygonSplitting = betterPolygonSplitting; }
 
+        [[nodiscard]] bool GpuTiming() const noexcept { return _gpuTiming; }
+        void SetGpuTiming(bool gpuTiming) noexcept { _gpuTiming = gpuTiming; }
+
         [[nodiscard]] RenderMode ConfiguredRenderer() const noexcept { return _configuredRenderer; }
         void SetConfiguredRenderer(RenderMode configuredRenderer) noexcept { _configuredRenderer = configuredRenderer; }
 
@@ -417,7 +438,8 @@ namespace MelonDsDs {
         bool _fastMemory;
 #   endif
 #endif
-
+        MelonDsDs::ThreadAffinity _threadAffinity = ThreadAffinity::Default;
+        MelonDsDs::ThreadPriority _threadPriority = ThreadPriority::Default;
 
 #ifdef HAVE_NETWORKING
         MelonDsDs::NetworkMode _networkMode;
@@ -465,11 +487,16 @@ namespace MelonDsDs {
         MelonDsDs::SysfileMode _sysfileMode;
         unsigned _dsPowerOkayThreshold = 20;
         unsigned _powerUpdateInterval;
+        unsigned _runAheadFrames = 0;
+        bool _lazyInputPolling = false;
+        MelonDsDs::MovieMode _movieMode = MovieMode::Disabled;
+        MelonDsDs::CaptureMode _captureMode = CaptureMode::Disabled;
         string _firmwarePath;
         string _dsiFirmwarePath;
         string _dsiNandPath;
         int _scaleFactor = 1;
         bool _betterPolygonSplitting = false;
+        bool _gpuTiming = false;
         RenderMode _configuredRenderer;
         bool _threadedSoftRenderer = false;
         MelonDsDs::ScreenFilter _screenFilter;
@@ -35,9 +35,11 @@
 #include <string/stdstring.h>
 
 #include "config.hpp"
+#include "console/lazyinput.hpp"
 #include "environment.hpp"
 #include "exceptions.hpp"
 #include "format.hpp"
+#include "platform/file.hpp"
 #include "retro/file.hpp"
 #include "retro/http.hpp"
 #include "retro/info.hpp"
@@ -84,7 +86,8 @@ namespace MelonDsDs {
     static bool LoadBios(const string_view& name, BiosType type, std::span<uint8_t> buffer) noexcept;
     static void CustomizeFirmware(const CoreConfig& config, Firmware& firmware);
     static std::optional<std::string> GetUsername(UsernameMode mode) noexcept;
-    static NANDImage LoadNANDImage(const string& nandPath, const uint8_t* es_keyY);
+    static NANDImage LoadNANDImage(const string& nandPath, const uint8_t* es_keyY, bool copyOnWrite);
+    static bool IsTitleInstalled(const string& nandPath, const uint8_t* es_keyY, const NDSHeader& header);
     static void CustomizeNAND(const CoreConfig& config, NANDMount& mount, const NDSHeader* header, string_view nandName);
     static optional<melonDS::FATStorage> LoadDSiSDCardImage(const CoreConfig& config) noexcept;
     static std::optional<std::u16string> ConvertUsername(string_view str) noexcept;
@@ -141,11 +144,11 @@ std::unique_ptr<melonDS::NDS> MelonDsDs::CreateConsole(
                 "The DSi does not support GBA connectivity. Not loading the requested GBA ROM or SRAM."
             );
         }
-        return std::make_unique<melonDS::DSi>(GetDSiArgs(config, ndsInfo), &state);
+        return std::make_unique<LazyInputConsole<melonDS::DSi>>(state, GetDSiArgs(config, ndsInfo), &state);
     }
     else {
         // If we're in DS mode...
-        return std::make_unique<melonDS::NDS>(GetNdsArgs(config, ndsInfo, gbaInfo, gbaSaveInfo, state), &state);
+        return std::make_unique<LazyInputConsole<melonDS::NDS>>(state, GetNdsArgs(config, ndsInfo, gbaInfo, gbaSaveInfo, state), &state);
     }
 }
 
@@ -375,7 +378,13 @@ static melonDS::DSiArgs MelonDsDs::GetDSiArgs(const CoreConfig& config, const re
         throw environment_exception("Failed to get the system directory, which means the NAND image can't be loaded.");
     }
 
-    NANDImage nand = LoadNANDImage(*nandPath, &(*arm7i)[0x8308]);
+    const NDSHeader* header = ndsInfo ? reinterpret_cast<const NDSHeader*>(ndsInfo->GetData().data()) : nullptr;
+
+    // DSiWare that isn't already on the NAND is only installed for the duration of the session,
+    // so the NAND image itself is never touched; changes are discarded when the session ends.
+    // Titles that were installed permanently keep their save data on the NAND, so it has to be written as usual.
+    bool copyOnWrite = header && header->IsDSiWare() && !IsTitleInstalled(*nandPath, &(*arm7i)[0x8308], *header);
+    NANDImage nand = LoadNANDImage(*nandPath, &(*arm7i)[0x8308], copyOnWrite);
     unique_ptr<melonDS::NDSCart::CartCommon> ndsRom = ndsInfo ? LoadNdsCart(config, *ndsInfo) : nullptr;
 
     { // Scoped to limit the mount's lifetime
@@ -385,7 +394,6 @@ static melonDS::DSiArgs MelonDsDs::GetDSiArgs(const CoreConfig& config, const re
         }
         retro::debug("Opened and mounted the DSi NAND image file at {}", *nandPath);
 
-        const NDSHeader* header = ndsInfo ? reinterpret_cast<const NDSHeader*>(ndsInfo->GetData().data()) : nullptr;
         CustomizeNAND(config, mount, header, nandName);
 
         if (ndsInfo && ndsRom != nullptr && ndsRom->GetHeader().IsDSiWare()) {
@@ -461,8 +469,14 @@ static unique_ptr<melonDS::NDSCart::CartCommon> MelonDsDs::LoadNdsCart(const Cor
         throw invalid_rom_exception("ROM isn't valid, did you select the right file?");
     }
 
+    optional<melonDS::FATStorageArgs> sdCard = config.DldiSdCardArgs();
+    if (sdCard) {
+        // melonDS opens the SD card image itself, and reads and writes it a few sectors at a time
+        SetFileAccessHints(sdCard->Filename, RETRO_VFS_FILE_ACCESS_HINT_FREQUENT_ACCESS);
+    }
+
     melonDS::NDSCart::NDSCartArgs sdargs = {
-        .SDCard = config.DldiSdCardArgs(),
+        .SDCard = std::move(sdCard),
         .SRAM = nullptr, // SRAM is loaded separately by retro_get_memory
         .SRAMLength = 0,
     };
@@ -587,42 +601,45 @@ void MelonDsDs::InstallDsiware(NANDMount& mount, const retro::GameInfo& nds_info
     retro_assert(header.IsDSiWare());
 
     if (mount.TitleExists(header.DSiTitleIDHigh, header.DSiTitleIDLow)) {
-        retro::info("Title \"{}\" already exists on loaded NAND; skipping installation, and won't uninstall it later.", path);
+        // The NAND was opened read-write, and its copy of the save data is the newest one
+        retro::info("Title \"{}\" already exists on loaded NAND; skipping installation.", path);
+        return;
+    }
 
-    } else {
-        retro::info("Title \"{}\" is not on loaded NAND; will install it for the duration of this session.", path);
+    retro::info("Title \"{}\" is not on loaded NAND; will install it for the duration of this session.", path);
 
-        char tmd_path[PATH_MAX];
-        GetTmdPath(nds_info, tmd_path);
+    char tmd_path[PATH_MAX];
+    GetTmdPath(nds_info, tmd_path);
 
-        optional<TitleMetadata> tmd = GetCachedTmd(tmd_path);
+    optional<TitleMetadata> tmd = GetCachedTmd(tmd_path);
 
-        if (!tmd) {
-            // If the TMD isn't available locally...
+    if (!tmd) {
+        // If the TMD isn't available locally...
 
 #ifdef HAVE_NETWORKING
-            if (tmd = DownloadTmd(header, tmd_path); !tmd) {
-                // ...then download it and save it to disk. If that didn't work...
-                throw missing_metadata_exception("Cannot get title metadata for installation");
-            }
+        if (tmd = DownloadTmd(header, tmd_path); !tmd) {
+            // ...then download it and save it to disk. If that didn't work...
+            throw missing_metadata_exception("Cannot get title metadata for installation");
+        }
 #else
-            throw missing_metadata_exception("Cannot get title metadata for installation, and this build does not support downloading it");
+        throw missing_metadata_exception("Cannot get title metadata for installation, and this build does not support downloading it");
 #endif
-        }
+    }
 
-        if (!mount.ImportTitle(reinterpret_cast<const uint8_t*>(data.data()), data.size(), *tmd, false)) {
-            throw emulator_exception("Failed to import DSiWare title into NAND image");
-        }
+    if (!mount.ImportTitle(reinterpret_cast<const uint8_t*>(data.data()), data.size(), *tmd, false)) {
+        throw emulator_exception("Failed to import DSiWare title into NAND image");
+    }
 
-        ImportDsiwareSaveData(mount, nds_info, header, TitleData_PublicSav);
-        ImportDsiwareSaveData(mount, nds_info, header, TitleData_PrivateSav);
-        ImportDsiwareSaveData(mount, nds_info, header, TitleData_BannerSav);
+    uint8_t zero = 0;
+    auto sentinel = fmt::format("0:/title/{:08x}/{:08x}/data/{}", header.DSiTitleIDHigh, header.DSiTitleIDLow, SENTINEL_NAME);
+    mount.RemoveFile(sentinel.c_str());
+    mount.ImportFile(sentinel.c_str(), &zero, sizeof(zero));
 
-        uint8_t zero = 0;
-        auto sentinel = fmt::format("0:/title/{:08x}/{:08x}/data/{}", header.DSiTitleIDHigh, header.DSiTitleIDLow, SENTINEL_NAME);
-        mount.RemoveFile(sentinel.c_str());
-        mount.ImportFile(sentinel.c_str(), &zero, sizeof(zero));
-    }
+    // The title (and its save data) will be discarded with the rest of the NAND's changes,
+    // so the save data that was exported last time is the newest copy
+    ImportDsiwareSaveData(mount, nds_info, header, TitleData_PublicSav);
+    ImportDsiwareSaveData(mount, nds_info, header, TitleData_PrivateSav);
+    ImportDsiwareSaveData(mount, nds_info, header, TitleData_BannerSav);
 }
 
 static void MelonDsDs::GetTmdPath(const retro::GameInfo &nds_info, std::span<char> buffer) {
@@ -858,6 +875,7 @@ static bool MelonDsDs::LoadBios(const string_view& name, BiosType type, std::spa
     ZoneScopedN(TracyFunction);
 
     auto LoadBiosImpl = [&](const string& path) -> bool {
+        // BIOS images are read exactly once, in one call, so there's nothing to gain from buffering them
         RFILE* file = filestream_open(path.c_str(), RETRO_VFS_FILE_ACCESS_READ, RETRO_VFS_FILE_ACCESS_HINT_NONE);
 
         if (!file) {
@@ -1166,10 +1184,12 @@ static std::optional<std::u16string> MelonDsDs::ConvertUsername(string_view str)
 }
 
 /// Loads the DSi NAND, does not patch it
-static NANDImage MelonDsDs::LoadNANDImage(const string& nandPath, const uint8_t* es_keyY) {
+static NANDImage MelonDsDs::LoadNANDImage(const string& nandPath, const uint8_t* es_keyY, bool copyOnWrite) {
     ZoneScopedN(TracyFunction);
     using namespace melonDS::Platform;
-    FileHandle* nandFile = OpenLocalFile(nandPath, FileMode::ReadWriteExisting);
+    // The NAND is read and written a few sectors at a time for as long as the console runs
+    SetFileAccessHints(nandPath, RETRO_VFS_FILE_ACCESS_HINT_FREQUENT_ACCESS);
+    FileHandle* nandFile = copyOnWrite ? OpenCopyOnWriteFile(nandPath) : OpenLocalFile(nandPath, FileMode::ReadWriteExisting);
     if (!nandFile) {
         throw dsi_nand_missing_exception(nandPath);
     }
@@ -1183,6 +1203,16 @@ static NANDImage MelonDsDs::LoadNANDImage(const string& nandPath, const uint8_t*
     return nand;
 }
 
+// Checks whether the given DSiWare title was installed on the NAND before this session
+static bool MelonDsDs::IsTitleInstalled(const string& nandPath, const uint8_t* es_keyY, const NDSHeader& header) {
+    ZoneScopedN(TracyFunction);
+
+    // Opened copy-on-write so that checking can't change anything
+    NANDImage nand = LoadNANDImage(nandPath, es_keyY, true);
+    NANDMount mount(nand);
+    return mount && mount.TitleExists(header.DSiTitleIDHigh, header.DSiTitleIDLow);
+}
+
 static void MelonDsDs::CustomizeNAND(const CoreConfig& config, NANDMount& mount, const NDSHeader* header, string_view nandName) {
     ZoneScopedN(TracyFunction);
     using namespace MelonDsDs::config::system;
@@ -1315,6 +1345,7 @@ static optional<melonDS::FATStorage> MelonDsDs::LoadDSiSDCardImage(const CoreCon
     ZoneScopedN(TracyFunction);
     if (!config.DsiSdEnable()) return nullopt;
 
+    SetFileAccessHints(string(config.DsiSdImagePath()), RETRO_VFS_FILE_ACCESS_HINT_FREQUENT_ACCESS);
     return melonDS::FATStorage(
         string(config.DsiSdImagePath()),
         config.DsiSdImageSize(),
@@ -45,10 +45,7 @@ bool MelonDsDs::config::IsDsiNandImage(const retro::dirent &file) noexcept {
     ZoneScopedN(TracyFunction);
     ZoneText(file.path, strnlen(file.path, sizeof(file.path)));
 
-    if (!file.is_regular_file())
-        return false;
-
-    switch (file.size) {
+    switch (file.size()) {
         case DSI_NAND_SIZES_NOFOOTER[0] + NOCASH_FOOTER_SIZE: // 240MB + no$gba footer
         case DSI_NAND_SIZES_NOFOOTER[1] + NOCASH_FOOTER_SIZE: // 245.5MB + no$gba footer
         case DSI_NAND_SIZES_NOFOOTER[0]: // 240MB
@@ -58,6 +55,10 @@ bool MelonDsDs::config::IsDsiNandImage(const retro::dirent &file) noexcept {
             return false;
     }
 
+    // Checked after the size so that most files don't need to be stat'ed twice
+    if (!file.is_regular_file())
+        return false;
+
     RFILE* stream = filestream_open(file.path, RETRO_VFS_FILE_ACCESS_READ, RETRO_VFS_FILE_ACCESS_HINT_NONE);
     if (!stream)
         return false;
@@ -105,21 +106,21 @@ bool MelonDsDs::config::IsFirmwareImage(const retro::dirent& file, Firmware::Fir
 
     retro_assert(path_is_absolute(file.path));
 
-    if (!file.is_regular_file()) {
-        retro::debug("{} is not a regular file, it's not firmware", file.path);
-        return false;
-    }
-
-    if (find(FIRMWARE_SIZES.begin(), FIRMWARE_SIZES.end(), file.size) == FIRMWARE_SIZES.end()) {
+    if (find(FIRMWARE_SIZES.begin(), FIRMWARE_SIZES.end(), file.size()) == FIRMWARE_SIZES.end()) {
         retro::debug(
             "{} is not a known firmware size (found {} bytes, must be one of {})",
             file.path,
-            file.size,
+            file.size(),
             fmt::join(FIRMWARE_SIZES, ", ")
         );
         return false;
     }
 
+    if (!file.is_regular_file()) {
+        retro::debug("{} is not a regular file, it's not firmware", file.path);
+        return false;
+    }
+
     if (string_ends_with(file.path, ".bak")) {
         retro::debug("{} is a backup file, not counting it as firmware", file.path);
         return false;
@@ -184,16 +185,17 @@ std::optional<melonDS::MacAddress> MelonDsDs::config::ParseMacAddressFile(const
     ZoneText(file.path, strnlen(file.path, sizeof(file.path)));
     retro::debug("Reading file {}", file.path);
 
-    if(!file.is_regular_file()) {
-        retro::debug("{} is not a regular file, it's not a mac address file", file.path);
+    if(!string_ends_with(file.path, ".txt")) {
+        retro::debug("{} is not a mac address file, it does not end with .txt", file.path);
         return std::nullopt;
     }
 
-    if(!string_ends_with(file.path, ".txt")) {
-        retro::debug("{} is not a mac address file, it does not end with .txt", file.path);
+    if(!file.is_regular_file()) {
+        retro::debug("{} is not a regular file, it's not a mac address file", file.path);
         return std::nullopt;
     }
-    if (file.size < MacAddressStringSize) {
+
+    if (file.size() < MacAddressStringSize) {
         retro::debug("{} is not a mac address file, it is too small", file.path);
         return std::nullopt;
     }
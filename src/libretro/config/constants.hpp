@@ -55,6 +55,8 @@ namespace MelonDsDs::config {
         static constexpr const char *const JIT_ENABLE = "melonds_jit_enable";
         static constexpr const char *const JIT_FAST_MEMORY = "melonds_jit_fast_memory";
         static constexpr const char *const JIT_LITERAL_OPTIMISATIONS = "melonds_jit_literal_optimisations";
+        static constexpr const char *const THREAD_AFFINITY = "melonds_thread_affinity";
+        static constexpr const char *const THREAD_PRIORITY = "melonds_thread_priority";
     }
 
     namespace firmware {
@@ -125,6 +127,7 @@ namespace MelonDsDs::config {
     }
 
     namespace system {
+        constexpr unsigned MAX_RUNAHEAD_FRAMES = 4;
         static constexpr const char *const CATEGORY = "system";
         static constexpr const char *const BATTERY_UPDATE_INTERVAL = "melonds_battery_update_interval";
         static constexpr const char *const BOOT_MODE = "melonds_boot_mode";
@@ -132,9 +135,13 @@ namespace MelonDsDs::config {
         static constexpr const char *const DS_POWER_OK = "melonds_ds_battery_ok_threshold";
         static constexpr const char *const FIRMWARE_PATH = "melonds_firmware_nds_path";
         static constexpr const char *const FIRMWARE_DSI_PATH = "melonds_firmware_dsi_path";
+        static constexpr const char *const FRAME_CAPTURE = "melonds_frame_capture";
+        static constexpr const char *const LAZY_INPUT_POLLING = "melonds_lazy_input_polling";
+        static constexpr const char *const MOVIE_MODE = "melonds_movie_mode";
         static constexpr const char *const OVERRIDE_FIRMWARE_SETTINGS = "melonds_override_fw_settings";
         static constexpr const char *const RUMBLE_INTENSITY = "melonds_rumble_intensity";
         static constexpr const char *const RUMBLE_TYPE = "melonds_rumble_type";
+        static constexpr const char *const RUNAHEAD_FRAMES = "melonds_runahead_frames";
         static constexpr const char *const SLOT2_DEVICE = "melonds_slot2_device";
         static constexpr const char *const SOLAR_SENSOR_HOST_SENSOR = "melonds_solar_sensor_host_sensor";
         static constexpr const char *const SYSFILE_MODE = "melonds_sysfile_mode";
@@ -172,6 +179,7 @@ namespace MelonDsDs::config {
         static constexpr const char *const CATEGORY = "video";
         static constexpr const char *const OPENGL_BETTER_POLYGONS = "melonds_opengl_better_polygons";
         static constexpr const char *const OPENGL_FILTERING = "melonds_opengl_filtering";
+        static constexpr const char *const OPENGL_GPU_TIMING = "melonds_opengl_gpu_timing";
         static constexpr const char *const OPENGL_RESOLUTION = "melonds_opengl_resolution";
         static constexpr const char *const RENDER_MODE = "melonds_render_mode";
         static constexpr const char *const THREADED_RENDERER = "melonds_threaded_renderer";
@@ -218,11 +226,14 @@ namespace MelonDsDs::config {
         static constexpr const char *const EXISTING = "existing";
         static constexpr const char *const EXPANSION_PAK = "expansion-pak";
         static constexpr const char *const FIRMWARE = "firmware";
+        static constexpr const char *const FIXED_TIME = "fixed";
         static constexpr const char *const FLIPPED_HYBRID_BOTTOM = "flipped-hybrid-bottom";
         static constexpr const char *const FLIPPED_HYBRID_TOP = "flipped-hybrid-top";
+        static constexpr const char *const FRAMES = "frames";
         static constexpr const char *const FRENCH = "fr";
         static constexpr const char *const GAUSSIAN = "gaussian";
         static constexpr const char *const GERMAN = "de";
+        static constexpr const char *const HIGH = "high";
         static constexpr const char *const HOLD = "hold";
         static constexpr const char *const HYBRID_BOTTOM = "hybrid-bottom";
         static constexpr const char *const HYBRID_TOP = "hybrid-top";
@@ -240,7 +251,11 @@ namespace MelonDsDs::config {
         static constexpr const char *const NOT_FOUND = "/notfound";
         static constexpr const char *const ONE = "one";
         static constexpr const char *const OPENGL = "opengl";
+        static constexpr const char *const PERFORMANCE = "performance";
+        static constexpr const char *const PLAY = "play";
+        static constexpr const char *const RAW = "raw";
         static constexpr const char *const REAL = "real";
+        static constexpr const char *const RECORD = "record";
         static constexpr const char *const RELATIVE_TIME = "relative";
         static constexpr const char *const RIGHT_LEFT = "right-left";
         static constexpr const char *const ROTATE_LEFT = "rotate-left";
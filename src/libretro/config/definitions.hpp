@@ -49,6 +49,8 @@ namespace MelonDsDs::config::definitions {
         JitFastMemory,
 #   endif
 #endif
+        ThreadAffinity,
+        ThreadPriority,
 
         LanMacAddressMode,
 #ifdef HAVE_NETWORKING
@@ -101,6 +103,10 @@ namespace MelonDsDs::config::definitions {
         HomebrewSdCardSyncToHost,
         BatteryUpdateInterval,
         NdsPowerOkThreshold,
+        RunAheadFrames,
+        LazyInputPolling,
+        MovieMode,
+        FrameCapture,
 
         StartTimeMode,
         RelativeYearOffset,
@@ -117,6 +123,7 @@ namespace MelonDsDs::config::definitions {
         RenderMode,
         OpenGlScaleFactor,
         OpenGlBetterPolygons,
+        OpenGlGpuTiming,
 #endif
 #if defined(HAVE_THREADS) && defined(HAVE_THREADED_RENDERER)
         ThreadedSoftwareRenderer,
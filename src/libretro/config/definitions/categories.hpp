@@ -59,13 +59,11 @@ namespace MelonDsDs::config::definitions {
             "Network",
             "Change Nintendo Wi-Fi emulation settings."
         },
-#ifdef JIT_ENABLED
         retro_core_option_v2_category {
             MelonDsDs::config::cpu::CATEGORY,
             "CPU Emulation",
-            "Change CPU emulation settings."
+            "Change CPU emulation and host threading settings."
         },
-#endif
         retro_core_option_v2_category {
             MelonDsDs::config::osd::CATEGORY,
             "On-Screen Display & Notifications",
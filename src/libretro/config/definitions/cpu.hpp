@@ -147,6 +147,46 @@ namespace MelonDsDs::config::definitions {
 #   endif
 #endif
 
+    constexpr retro_core_option_v2_definition ThreadAffinity {
+        config::cpu::THREAD_AFFINITY,
+        "Thread Affinity",
+        nullptr,
+        "Controls which of the host's CPU cores the emulator's threads can run on. "
+        "On devices with both fast and power-efficient cores (such as many phones and handhelds), "
+        "Performance Cores keeps emulation and rendering off of the slowest cores "
+        "and moves background work (such as frame capture) onto them. "
+        "Does nothing if all cores run at the same speed or if the platform doesn't support it. "
+        "Threads that are already running are updated when they next start. "
+        "If unsure, leave at Default.",
+        nullptr,
+        MelonDsDs::config::cpu::CATEGORY,
+        {
+            {MelonDsDs::config::values::DEFAULT, "Default"},
+            {MelonDsDs::config::values::PERFORMANCE, "Performance Cores"},
+            {nullptr, nullptr},
+        },
+        MelonDsDs::config::values::DEFAULT
+    };
+
+    constexpr retro_core_option_v2_definition ThreadPriority {
+        config::cpu::THREAD_PRIORITY,
+        "Thread Priority",
+        nullptr,
+        "High raises the scheduling priority of the emulation and rendering threads "
+        "and lowers that of background work. "
+        "Some platforms only let a process lower its own priority, "
+        "in which case only the background threads are affected. "
+        "If unsure, leave at Default.",
+        nullptr,
+        MelonDsDs::config::cpu::CATEGORY,
+        {
+            {MelonDsDs::config::values::DEFAULT, "Default"},
+            {MelonDsDs::config::values::HIGH, "High"},
+            {nullptr, nullptr},
+        },
+        MelonDsDs::config::values::DEFAULT
+    };
+
     constexpr std::initializer_list<retro_core_option_v2_definition> CpuOptionDefinitions {
 #ifdef JIT_ENABLED
         JitEnabled,
@@ -157,6 +197,8 @@ namespace MelonDsDs::config::definitions {
         JitFastMemory,
 #   endif
 #endif
+        ThreadAffinity,
+        ThreadPriority,
     };
 }
 #endif //MELONDS_DS_CPU_HPP
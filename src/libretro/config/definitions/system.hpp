@@ -384,6 +384,110 @@ namespace MelonDsDs::config::definitions {
         values::ENABLED
     };
 
+    constexpr retro_core_option_v2_definition RunAheadFrames {
+        config::system::RUNAHEAD_FRAMES,
+        "Run-Ahead Frames",
+        nullptr,
+        "Runs the emulated console this many frames ahead of what you see, "
+        "then rolls it back to hide the game's own input lag. "
+        "Much cheaper than the frontend's run-ahead feature, "
+        "which should be disabled if this option is used. "
+        "Each extra frame costs roughly one more frame of emulation.\n"
+        "\n"
+        "Not available in DSi mode. "
+        "May cause problems with local wireless multiplayer. "
+        "Changes take effect immediately. "
+        "If unsure, leave disabled.",
+        nullptr,
+        config::system::CATEGORY,
+        {
+            {"0", "Disabled"},
+            {"1", "1 frame"},
+            {"2", "2 frames"},
+            {"3", "3 frames"},
+            {"4", "4 frames"},
+            {nullptr, nullptr},
+        },
+        "0"
+    };
+
+    constexpr retro_core_option_v2_definition LazyInputPolling {
+        config::system::LAZY_INPUT_POLLING,
+        "Late Input Polling",
+        nullptr,
+        "If enabled, input is read from the frontend when the emulated game first checks "
+        "the buttons, touch screen, or lid in each frame, instead of before the frame starts. "
+        "Can remove up to one frame of input lag "
+        "without the overhead of run-ahead. "
+        "Changes take effect immediately. "
+        "If unsure, leave disabled.",
+        nullptr,
+        config::system::CATEGORY,
+        {
+            {MelonDsDs::config::values::DISABLED, nullptr},
+            {MelonDsDs::config::values::ENABLED, nullptr},
+            {nullptr, nullptr},
+        },
+        MelonDsDs::config::values::DISABLED
+    };
+
+    constexpr retro_core_option_v2_definition MovieMode {
+        config::system::MOVIE_MODE,
+        "Input Movie",
+        nullptr,
+        "Records the emulated console's input to a movie file in the save directory, "
+        "or plays it back exactly as it was recorded. "
+        "Recording starts when the game boots, "
+        "and starts over from the current point if a savestate is loaded. "
+        "While a movie is recording or playing, "
+        "the emulated clock always starts at the configured date and time, "
+        "and the player's input is ignored during playback. "
+        "Useful for reproducing bugs or comparing performance.\n"
+        "\n"
+        "Audio from the host's microphone is not recorded; "
+        "it will be replaced by silence during playback. "
+        "Don't use with the frontend's rewind or run-ahead features, "
+        "since they load savestates constantly. "
+        "Changes take effect at next restart. "
+        "If unsure, leave disabled.",
+        nullptr,
+        config::system::CATEGORY,
+        {
+            {MelonDsDs::config::values::DISABLED, "Disabled"},
+            {MelonDsDs::config::values::RECORD, "Record"},
+            {MelonDsDs::config::values::PLAY, "Play"},
+            {nullptr, nullptr},
+        },
+        MelonDsDs::config::values::DISABLED
+    };
+
+    constexpr retro_core_option_v2_definition FrameCapture {
+        config::system::FRAME_CAPTURE,
+        "Frame Capture",
+        nullptr,
+        "Saves every frame that the emulated console shows to the save directory, "
+        "at the renderer's native resolution and without the screen layout or cursor. "
+        "Frames are written by a background thread, "
+        "and are skipped (not delayed) if it falls behind.\n"
+        "\n"
+        "Frames: Saves each frame as a separate PPM image. "
+        "Raw Video: Appends each frame to a single file of uncompressed BGRA pixels "
+        "that can be converted with ffmpeg (see the log for the exact command).\n"
+        "\n"
+        "Uses a lot of disk space. "
+        "Changes take effect immediately. "
+        "If unsure, leave disabled.",
+        nullptr,
+        config::system::CATEGORY,
+        {
+            {MelonDsDs::config::values::DISABLED, "Disabled"},
+            {MelonDsDs::config::values::FRAMES, "Frames"},
+            {MelonDsDs::config::values::RAW, "Raw Video"},
+            {nullptr, nullptr},
+        },
+        MelonDsDs::config::values::DISABLED
+    };
+
     constexpr std::initializer_list<retro_core_option_v2_definition> SystemOptionDefinitions {
         ConsoleMode,
         SysfileMode,
@@ -400,6 +504,10 @@ namespace MelonDsDs::config::definitions {
         HomebrewSdCardSyncToHost,
         BatteryUpdateInterval,
         NdsPowerOkThreshold,
+        RunAheadFrames,
+        LazyInputPolling,
+        MovieMode,
+        FrameCapture,
     };
 }
 
@@ -83,6 +83,25 @@ namespace MelonDsDs::config::definitions {
         },
         MelonDsDs::config::values::DISABLED
     };
+
+    constexpr retro_core_option_v2_definition OpenGlGpuTiming {
+        config::video::OPENGL_GPU_TIMING,
+        "GPU Timing",
+        nullptr,
+        "If enabled, measures how long the GPU spends emulating and presenting each frame, "
+        "and reports it to profilers such as Tracy. "
+        "Useful for finding out why OpenGL mode is slow. "
+        "Has a small performance cost; leave this disabled if unsure. "
+        "OpenGL renderer only.",
+        nullptr,
+        config::video::CATEGORY,
+        {
+            {MelonDsDs::config::values::DISABLED, nullptr},
+            {MelonDsDs::config::values::ENABLED, nullptr},
+            {nullptr, nullptr},
+        },
+        MelonDsDs::config::values::DISABLED
+    };
 #endif
 #if defined(HAVE_THREADS) && defined(HAVE_THREADED_RENDERER)
     constexpr retro_core_option_v2_definition ThreadedSoftwareRenderer {
@@ -108,6 +127,7 @@ namespace MelonDsDs::config::definitions {
         RenderMode,
         OpenGlScaleFactor,
         OpenGlBetterPolygons,
+        OpenGlGpuTiming,
 #endif
 #if defined(HAVE_THREADS) && defined(HAVE_THREADED_RENDERER)
         ThreadedSoftwareRenderer,
@@ -193,6 +193,36 @@ namespace MelonDsDs {
         return std::nullopt;
     }
 
+    constexpr std::optional<MelonDsDs::MovieMode> ParseMovieMode(std::string_view value) noexcept {
+        if (value == config::values::DISABLED) return MovieMode::Disabled;
+        if (value == config::values::RECORD) return MovieMode::Record;
+        if (value == config::values::PLAY) return MovieMode::Play;
+
+        return std::nullopt;
+    }
+
+    constexpr std::optional<MelonDsDs::CaptureMode> ParseCaptureMode(std::string_view value) noexcept {
+        if (value == config::values::DISABLED) return CaptureMode::Disabled;
+        if (value == config::values::FRAMES) return CaptureMode::Frames;
+        if (value == config::values::RAW) return CaptureMode::RawVideo;
+
+        return std::nullopt;
+    }
+
+    constexpr std::optional<MelonDsDs::ThreadAffinity> ParseThreadAffinity(std::string_view value) noexcept {
+        if (value == config::values::DEFAULT) return ThreadAffinity::Default;
+        if (value == config::values::PERFORMANCE) return ThreadAffinity::Performance;
+
+        return std::nullopt;
+    }
+
+    constexpr std::optional<MelonDsDs::ThreadPriority> ParseThreadPriority(std::string_view value) noexcept {
+        if (value == config::values::DEFAULT) return ThreadPriority::Default;
+        if (value == config::values::HIGH) return ThreadPriority::High;
+
+        return std::nullopt;
+    }
+
     constexpr std::optional<MelonDsDs::TouchMode> ParseTouchMode(std::string_view value) noexcept {
         if (value == config::values::AUTO) return TouchMode::Auto;
         if (value == config::values::TOUCH) return TouchMode::Pointer;
@@ -231,6 +261,7 @@ namespace MelonDsDs {
         if (value == config::values::SYNC) return StartTimeMode::Sync;
         if (value == config::values::RELATIVE_TIME) return StartTimeMode::Relative;
         if (value == config::values::ABSOLUTE_TIME) return StartTimeMode::Absolute;
+        if (value == config::values::FIXED_TIME) return StartTimeMode::Fixed;
 
         return std::nullopt;
     }
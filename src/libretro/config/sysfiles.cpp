@@ -0,0 +1,219 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "sysfiles.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <string_view>
+#include <utility>
+
+#include <fmt/format.h>
+#include <streams/file_stream.h>
+
+#include "config/constants.hpp"
+#include "environment.hpp"
+#include "retro/dirent.hpp"
+#include "tracy.hpp"
+
+using std::optional;
+using std::nullopt;
+using std::string;
+using std::string_view;
+using melonDS::Firmware::FirmwareConsoleType;
+using melonDS::Firmware::FirmwareHeader;
+
+// Bump this whenever the format changes or the classifiers get stricter,
+// so that stale indexes are thrown out instead of trusted.
+constexpr string_view INDEX_HEADER = "melonDS DS system file index 1";
+
+static MelonDsDs::config::SystemFileIndexStats _lastScanStats {};
+
+static bool IsSystemFileSize(int64_t size) noexcept {
+    using namespace MelonDsDs::config;
+    for (size_t nandSize : DSI_NAND_SIZES_NOFOOTER) {
+        if (size == (int64_t)nandSize || size == int64_t(nandSize + NOCASH_FOOTER_SIZE))
+            return true;
+    }
+
+    return std::find(FIRMWARE_SIZES.begin(), FIRMWARE_SIZES.end(), (size_t)size) != FIRMWARE_SIZES.end();
+}
+
+template<typename T>
+static optional<T> ParseField(string_view& line) noexcept {
+    size_t end = line.find(' ');
+    if (end == string_view::npos)
+        return nullopt;
+
+    T value {};
+    auto [ptr, ec] = std::from_chars(line.data(), line.data() + end, value);
+    if (ec != std::errc() || ptr != line.data() + end)
+        return nullopt;
+
+    line.remove_prefix(end + 1);
+    return value;
+}
+
+MelonDsDs::config::SystemFileIndex::SystemFileIndex(string path) noexcept : _path(std::move(path)) {
+    Load();
+}
+
+void MelonDsDs::config::SystemFileIndex::Load() noexcept {
+    ZoneScopedN(TracyFunction);
+
+    void* buffer = nullptr;
+    int64_t length = 0;
+    if (!filestream_exists(_path.c_str()) || !filestream_read_file(_path.c_str(), &buffer, &length) || !buffer) {
+        retro::debug("No system file index at \"{}\", will scan the system directory from scratch", _path);
+        _dirty = true;
+        return;
+    }
+
+    string_view contents(static_cast<const char*>(buffer), length);
+    size_t lineEnd = contents.find('\n');
+    if (contents.substr(0, lineEnd) != INDEX_HEADER) {
+        retro::info("System file index at \"{}\" is outdated or corrupt, will rebuild it", _path);
+        free(buffer);
+        _dirty = true;
+        return;
+    }
+
+    while (lineEnd != string_view::npos) {
+        contents.remove_prefix(lineEnd + 1);
+        lineEnd = contents.find('\n');
+        string_view line = contents.substr(0, lineEnd);
+        if (line.empty())
+            continue;
+
+        // Each line is "<type> <console type> <size> <mtime> <path>";
+        // the path goes last so that it can contain spaces
+        optional<unsigned> type = ParseField<unsigned>(line);
+        optional<unsigned> consoleType = ParseField<unsigned>(line);
+        optional<int64_t> size = ParseField<int64_t>(line);
+        optional<int64_t> mtime = ParseField<int64_t>(line);
+        if (!type || !consoleType || !size || !mtime || line.empty() || *type > (unsigned)SystemFileType::Firmware) {
+            // If this line is malformed, skip it; the file it describes will just be scanned again
+            _dirty = true;
+            continue;
+        }
+
+        _entries.insert_or_assign(string(line), Entry {
+            .Size = *size,
+            .ModifiedTime = (time_t)*mtime,
+            .Type = (SystemFileType)*type,
+            .ConsoleType = (FirmwareConsoleType)*consoleType,
+            .Seen = false,
+        });
+    }
+
+    free(buffer);
+    retro::debug("Loaded {} entries from the system file index at \"{}\"", _entries.size(), _path);
+}
+
+optional<MelonDsDs::config::SystemFile> MelonDsDs::config::SystemFileIndex::Classify(const retro::dirent& file) noexcept {
+    ZoneScopedN(TracyFunction);
+
+    if (!IsSystemFileSize(file.size()) || !file.is_regular_file()) {
+        // Most files in the system directory can be ruled out by size alone,
+        // so there's no point in stat'ing or indexing them
+        return nullopt;
+    }
+
+    SystemFile result;
+    if (stat(file.path, &result.Stat) != 0)
+        return nullopt;
+
+    if (auto it = _entries.find(file.path); it != _entries.end() && it->second.Size == (int64_t)result.Stat.st_size && it->second.ModifiedTime == result.Stat.st_mtime) {
+        // If we've seen this file before and it hasn't changed since...
+        ++_stats.Hits;
+        it->second.Seen = true;
+        result.Type = it->second.Type;
+        result.ConsoleType = it->second.ConsoleType;
+    } else {
+        // This file is new or has changed, so we need to look inside it
+        ++_stats.Misses;
+        FirmwareHeader header {};
+        if (IsDsiNandImage(file)) {
+            result.Type = SystemFileType::DsiNand;
+        } else if (IsFirmwareImage(file, header)) {
+            result.Type = SystemFileType::Firmware;
+            result.ConsoleType = header.ConsoleType;
+        }
+
+        _entries.insert_or_assign(file.path, Entry {
+            .Size = (int64_t)result.Stat.st_size,
+            .ModifiedTime = result.Stat.st_mtime,
+            .Type = result.Type,
+            .ConsoleType = result.ConsoleType,
+            .Seen = true,
+        });
+        _dirty = true;
+    }
+
+    if (result.Type == SystemFileType::None)
+        return nullopt;
+
+    return result;
+}
+
+bool MelonDsDs::config::SystemFileIndex::Save() noexcept {
+    ZoneScopedN(TracyFunction);
+
+    // Forget about files that were deleted or moved since the last scan
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->second.Seen) {
+            ++it;
+        } else {
+            it = _entries.erase(it);
+            _dirty = true;
+        }
+    }
+
+    if (!_dirty)
+        return true;
+
+    fmt::memory_buffer buffer;
+    fmt::format_to(std::back_inserter(buffer), "{}\n", INDEX_HEADER);
+    for (const auto& [path, entry] : _entries) {
+        fmt::format_to(
+            std::back_inserter(buffer),
+            "{} {} {} {} {}\n",
+            (unsigned)entry.Type,
+            (unsigned)entry.ConsoleType,
+            entry.Size,
+            (int64_t)entry.ModifiedTime,
+            path
+        );
+    }
+
+    if (!filestream_write_file(_path.c_str(), buffer.data(), buffer.size())) {
+        retro::warn("Failed to write the system file index to \"{}\"", _path);
+        return false;
+    }
+
+    retro::debug("Wrote {} entries to the system file index at \"{}\"", _entries.size(), _path);
+    _dirty = false;
+    return true;
+}
+
+const MelonDsDs::config::SystemFileIndexStats& MelonDsDs::config::GetSystemFileIndexStats() noexcept {
+    return _lastScanStats;
+}
+
+void MelonDsDs::config::SetSystemFileIndexStats(const SystemFileIndexStats& stats) noexcept {
+    _lastScanStats = stats;
+}
@@ -0,0 +1,96 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MELONDSDS_CONFIG_SYSFILES_HPP
+#define MELONDSDS_CONFIG_SYSFILES_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <sys/stat.h>
+
+#include <SPI_Firmware.h>
+
+namespace retro {
+    struct dirent;
+}
+
+namespace MelonDsDs::config {
+    enum class SystemFileType : uint8_t {
+        None,
+        DsiNand,
+        Firmware,
+    };
+
+    /// What a file in the system directory turned out to be.
+    struct SystemFile {
+        SystemFileType Type = SystemFileType::None;
+        /// Only meaningful if Type is SystemFileType::Firmware
+        melonDS::Firmware::FirmwareConsoleType ConsoleType = melonDS::Firmware::FirmwareConsoleType::DS;
+        struct stat Stat {};
+    };
+
+    struct SystemFileIndexStats {
+        /// Files whose type was taken from the index
+        uint64_t Hits = 0;
+        /// Files that had to be opened and inspected
+        uint64_t Misses = 0;
+    };
+
+    /// Remembers which files in the system directory are firmware or DSi NAND images,
+    /// so that scanning the directory on startup doesn't have to open them again.
+    /// Entries are keyed by path, size, and modification time;
+    /// if any of those change, the file is inspected again.
+    class SystemFileIndex {
+    public:
+        /// Loads the index from the given path.
+        /// If it doesn't exist or can't be read, the index starts out empty.
+        explicit SystemFileIndex(std::string path) noexcept;
+
+        /// Returns what the given file is, inspecting it only if the index doesn't already know.
+        /// Files that aren't the size of any firmware or NAND image are rejected without being looked up.
+        [[nodiscard]] std::optional<SystemFile> Classify(const retro::dirent& file) noexcept;
+
+        /// Writes the index back to disk if it changed,
+        /// leaving out entries for files that weren't seen by Classify.
+        bool Save() noexcept;
+
+        [[nodiscard]] const SystemFileIndexStats& Stats() const noexcept { return _stats; }
+    private:
+        struct Entry {
+            int64_t Size;
+            time_t ModifiedTime;
+            SystemFileType Type;
+            melonDS::Firmware::FirmwareConsoleType ConsoleType;
+            bool Seen;
+        };
+
+        void Load() noexcept;
+
+        std::string _path;
+        std::unordered_map<std::string, Entry> _entries {};
+        SystemFileIndexStats _stats {};
+        bool _dirty = false;
+    };
+
+    /// Returns the stats of the most recent system directory scan.
+    const SystemFileIndexStats& GetSystemFileIndexStats() noexcept;
+    void SetSystemFileIndexStats(const SystemFileIndexStats& stats) noexcept;
+}
+
+#endif // MELONDSDS_CONFIG_SYSFILES_HPP
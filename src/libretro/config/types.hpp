@@ -59,6 +59,33 @@ namespace MelonDsDs {
         Always,
     };
 
+    enum class MovieMode {
+        Disabled,
+        Record,
+        Play,
+    };
+
+    enum class CaptureMode {
+        Disabled,
+        /// One lossless image per frame
+        Frames,
+        /// One file of uncompressed frames that ffmpeg can read as rawvideo
+        RawVideo,
+    };
+
+    enum class ThreadAffinity {
+        /// Let the OS decide which cores each thread runs on
+        Default,
+        /// Keep emulation and rendering on the fastest cores, and everything else off of them
+        Performance,
+    };
+
+    enum class ThreadPriority {
+        Default,
+        /// Raise emulation and rendering threads' priority and lower everything else's
+        High,
+    };
+
     enum class TouchMode {
         Auto,
         Pointer,
@@ -176,6 +203,7 @@ namespace MelonDsDs {
         Sync,
         Relative,
         Absolute,
+        Fixed,
     };
 
     enum class FormattedGLEnum {};
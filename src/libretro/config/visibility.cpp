@@ -54,6 +54,7 @@ bool MelonDsDs::CoreOptionVisibility::Update() noexcept {
     if (!VisibilityInitialized || ShowOpenGlOptions != oldShowOpenGlOptions) {
         set_option_visible(video::OPENGL_RESOLUTION, ShowOpenGlOptions);
         set_option_visible(video::OPENGL_BETTER_POLYGONS, ShowOpenGlOptions);
+        set_option_visible(video::OPENGL_GPU_TIMING, ShowOpenGlOptions);
         updated = true;
     }
 #ifdef HAVE_THREADED_RENDERER
@@ -196,7 +197,7 @@ bool MelonDsDs::CoreOptionVisibility::Update() noexcept {
     }
 
     bool oldShowAbsoluteTime = ShowAbsoluteStartTime;
-    ShowAbsoluteStartTime = !timeMode || *timeMode == StartTimeMode::Absolute;
+    ShowAbsoluteStartTime = !timeMode || *timeMode == StartTimeMode::Absolute || *timeMode == StartTimeMode::Fixed;
     if (!VisibilityInitialized || ShowAbsoluteStartTime != oldShowAbsoluteTime) {
         set_option_visible(time::ABSOLUTE_YEAR, ShowAbsoluteStartTime);
         set_option_visible(time::ABSOLUTE_MONTH, ShowAbsoluteStartTime);
@@ -0,0 +1,106 @@
+/*
+    Copyright 2025 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "console/lazyinput.hpp"
+
+#include "core/core.hpp"
+
+using MelonDsDs::LazyInputConsole;
+
+// KEYINPUT is readable by both CPUs,
+// but only the ARM7 can read EXTKEYIN (X, Y, pen down, lid closed)
+// or talk to the touch screen controller over SPI.
+constexpr uint32_t KEYINPUT = 0x04000130;
+constexpr uint32_t EXTKEYIN = 0x04000136;
+constexpr uint32_t RCNT = 0x04000134; // 32-bit reads here include EXTKEYIN
+constexpr uint32_t SPIDATA = 0x040001C2;
+
+template<typename Console>
+uint8_t LazyInputConsole<Console>::ARM9IORead8(uint32_t addr) {
+    if ((addr & ~1u) == KEYINPUT) [[unlikely]] {
+        _core.OnInputRead(*this);
+    }
+
+    return Console::ARM9IORead8(addr);
+}
+
+template<typename Console>
+uint16_t LazyInputConsole<Console>::ARM9IORead16(uint32_t addr) {
+    if (addr == KEYINPUT) [[unlikely]] {
+        _core.OnInputRead(*this);
+    }
+
+    return Console::ARM9IORead16(addr);
+}
+
+template<typename Console>
+uint32_t LazyInputConsole<Console>::ARM9IORead32(uint32_t addr) {
+    if (addr == KEYINPUT) [[unlikely]] {
+        _core.OnInputRead(*this);
+    }
+
+    return Console::ARM9IORead32(addr);
+}
+
+template<typename Console>
+uint8_t LazyInputConsole<Console>::ARM7IORead8(uint32_t addr) {
+    if ((addr & ~1u) == KEYINPUT || (addr & ~1u) == EXTKEYIN) [[unlikely]] {
+        _core.OnInputRead(*this);
+    }
+
+    return Console::ARM7IORead8(addr);
+}
+
+template<typename Console>
+uint16_t LazyInputConsole<Console>::ARM7IORead16(uint32_t addr) {
+    if (addr == KEYINPUT || addr == EXTKEYIN) [[unlikely]] {
+        _core.OnInputRead(*this);
+    }
+
+    return Console::ARM7IORead16(addr);
+}
+
+template<typename Console>
+uint32_t LazyInputConsole<Console>::ARM7IORead32(uint32_t addr) {
+    if (addr == KEYINPUT || addr == RCNT) [[unlikely]] {
+        _core.OnInputRead(*this);
+    }
+
+    return Console::ARM7IORead32(addr);
+}
+
+template<typename Console>
+void LazyInputConsole<Console>::ARM7IOWrite8(uint32_t addr, uint8_t val) {
+    if (addr == SPIDATA) [[unlikely]] {
+        // The touch screen controller samples the pen's position when it receives a command,
+        // so the touch input must be in place before the command arrives
+        _core.OnInputRead(*this);
+    }
+
+    Console::ARM7IOWrite8(addr, val);
+}
+
+template<typename Console>
+void LazyInputConsole<Console>::ARM7IOWrite16(uint32_t addr, uint16_t val) {
+    if (addr == SPIDATA) [[unlikely]] {
+        _core.OnInputRead(*this);
+    }
+
+    Console::ARM7IOWrite16(addr, val);
+}
+
+template class MelonDsDs::LazyInputConsole<melonDS::NDS>;
+template class MelonDsDs::LazyInputConsole<melonDS::DSi>;
@@ -0,0 +1,54 @@
+/*
+    Copyright 2025 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include <NDS.h>
+#include <DSi.h>
+
+namespace MelonDsDs {
+    class CoreState;
+
+    /// Wraps an emulated console so that the core is notified
+    /// whenever the emulated game reads the keypad, the lid, or the touch screen.
+    /// This lets the core defer reading the frontend's input
+    /// until the moment the game actually needs it.
+    template<typename Console>
+    class LazyInputConsole final : public Console {
+    public:
+        template<typename... Args>
+        LazyInputConsole(CoreState& core, Args&&... args) :
+            Console(std::forward<Args>(args)...),
+            _core(core) {}
+
+        uint8_t ARM9IORead8(uint32_t addr) override;
+        uint16_t ARM9IORead16(uint32_t addr) override;
+        uint32_t ARM9IORead32(uint32_t addr) override;
+        uint8_t ARM7IORead8(uint32_t addr) override;
+        uint16_t ARM7IORead16(uint32_t addr) override;
+        uint32_t ARM7IORead32(uint32_t addr) override;
+        void ARM7IOWrite8(uint32_t addr, uint8_t val) override;
+        void ARM7IOWrite16(uint32_t addr, uint16_t val) override;
+    private:
+        CoreState& _core;
+    };
+
+    extern template class LazyInputConsole<melonDS::NDS>;
+    extern template class LazyInputConsole<melonDS::DSi>;
+}
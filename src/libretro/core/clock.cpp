@@ -0,0 +1,87 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "clock.hpp"
+
+#include <ctime>
+
+#undef isnan
+#include <fmt/chrono.h>
+
+#include "environment.hpp"
+#include "tracy.hpp"
+
+using namespace std::chrono;
+
+local_seconds MelonDsDs::LocalTime(system_clock::time_point time) noexcept {
+    ZoneScopedN(TracyFunction);
+    std::tm tm = fmt::localtime(system_clock::to_time_t(time));
+
+    year_month_day date {year{tm.tm_year + 1900}, month{tm.tm_mon + 1u}, day{(unsigned)tm.tm_mday}};
+    seconds timeOfDay = hours{tm.tm_hour} + minutes{tm.tm_min} + seconds{tm.tm_sec};
+
+    return static_cast<local_days>(date) + timeOfDay;
+}
+
+local_seconds MelonDsDs::LocalTime() noexcept {
+    return LocalTime(system_clock::now());
+}
+
+MelonDsDs::SyncedClock::SyncedClock() noexcept {
+    Resync();
+}
+
+void MelonDsDs::SyncedClock::Resync() noexcept {
+    ZoneScopedN(TracyFunction);
+    _steadyBase = steady_clock::now();
+    _systemBase = system_clock::now();
+
+    // to_time_t truncates to the second,
+    // so we'll account for the fraction ourselves in Tick
+    _localBase = LocalTime(_systemBase);
+    _lastTick = std::nullopt;
+}
+
+std::optional<local_seconds> MelonDsDs::SyncedClock::Tick() noexcept {
+    ZoneScopedN(TracyFunction);
+    steady_clock::duration elapsed = steady_clock::now() - _steadyBase;
+
+    if (elapsed >= RESYNC_INTERVAL) {
+        // If it's been a while since we last looked at the local time...
+        Resync();
+        elapsed = steady_clock::duration::zero();
+    }
+    else {
+        system_clock::duration drift = system_clock::now() - (_systemBase + duration_cast<system_clock::duration>(elapsed));
+        if (drift > MAX_DRIFT || drift < -MAX_DRIFT) {
+            // If the host's clock was changed since we last checked...
+            retro::debug("Host clock drifted by {}ms; resynchronizing", duration_cast<milliseconds>(drift).count());
+            Resync();
+            elapsed = steady_clock::duration::zero();
+        }
+    }
+
+    system_clock::duration fraction = _systemBase - floor<seconds>(_systemBase);
+    local_seconds now = _localBase + floor<seconds>(fraction + duration_cast<system_clock::duration>(elapsed));
+
+    if (_lastTick == now) {
+        // If we're still in the same second as last frame...
+        return std::nullopt;
+    }
+
+    _lastTick = now;
+    return now;
+}
@@ -0,0 +1,62 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MELONDSDS_CLOCK_HPP
+#define MELONDSDS_CLOCK_HPP
+
+#include <optional>
+
+#include "std/chrono.hpp"
+
+namespace MelonDsDs {
+    using std::chrono::local_seconds;
+
+    /// Converts the given moment to the host's local time.
+    /// This may hit the disk on some C libraries, so don't call it every frame.
+    [[nodiscard]] local_seconds LocalTime(std::chrono::system_clock::time_point time) noexcept;
+    [[nodiscard]] local_seconds LocalTime() noexcept;
+
+    /// Follows the host's local time using the monotonic clock,
+    /// so that the emulated RTC can stay in sync
+    /// without converting to local time every frame.
+    class SyncedClock {
+    public:
+        SyncedClock() noexcept;
+
+        /// Re-reads the host's local time, e.g. after loading a savestate
+        /// or if the host's clock was changed.
+        void Resync() noexcept;
+
+        /// @returns The current local time if a new second has started since the last call
+        /// (or since the last resync), otherwise \c std::nullopt.
+        [[nodiscard]] std::optional<local_seconds> Tick() noexcept;
+    private:
+        // Used to catch DST transitions and timezone changes,
+        // which don't show up as drift between the system and steady clocks
+        static constexpr std::chrono::minutes RESYNC_INTERVAL {1};
+
+        // If the host's wall clock disagrees with our estimate by this much,
+        // then it was probably changed (or the device was suspended)
+        static constexpr std::chrono::seconds MAX_DRIFT {2};
+
+        local_seconds _localBase {};
+        std::chrono::steady_clock::time_point _steadyBase {};
+        std::chrono::system_clock::time_point _systemBase {};
+        std::optional<local_seconds> _lastTick = std::nullopt;
+    };
+}
+
+#endif //MELONDSDS_CLOCK_HPP
@@ -28,6 +28,7 @@
 #include <file/file_path.h>
 #include <string/stdstring.h>
 
+#include "clock.hpp"
 #include "console/dsi.hpp"
 #include "constants.hpp"
 #include "../config/console.hpp"
@@ -36,6 +37,8 @@
 #include "../info.hpp"
 #include "../microphone.hpp"
 #include "../message/error.hpp"
+#include "../platform/file.hpp"
+#include "../platform/thread.hpp"
 #include "../render/render.hpp"
 #include "../retro/task_queue.hpp"
 #include "render/software.hpp"
@@ -57,17 +60,6 @@ static const char* const UNKNOWN_ERROR_MESSAGE =
     "An unknown error has occurred with melonDS DS. "
     "Please contact the developer with the log file.";
 
-date::local_seconds LocalTime() noexcept {
-    using namespace std::chrono;
-
-    std::tm tm = fmt::localtime(system_clock::to_time_t(system_clock::now()));
-
-    year_month_day date {year{tm.tm_year + 1900}, month{tm.tm_mon + 1u}, day{(unsigned)tm.tm_mday}};
-    seconds time = hours{tm.tm_hour} + minutes{tm.tm_min} + seconds{tm.tm_sec};
-
-    return static_cast<local_days>(date) + time;
-}
-
 MelonDsDs::CoreState::~CoreState() noexcept {
     ZoneScopedN(TracyFunction);
     Console = nullptr;
@@ -98,6 +90,11 @@ retro_system_av_info MelonDsDs::CoreState::GetSystemAvInfo() const noexcept {
 }
 
 void MelonDsDs::CoreState::UnloadGame() noexcept {
+    _movie.Stop();
+    _renderState.StopCapture();
+    _capture.Stop();
+    ResetEmulationThreadPolicy();
+
     if (Console && Console->IsRunning()) {
         // If the NDS wasn't already stopped due to some internal event...
         Console->Stop();
@@ -120,6 +117,10 @@ void MelonDsDs::CoreState::UnloadGame() noexcept {
 
     Console = nullptr;
     melonDS::NDS::Current = nullptr;
+
+    // The frontend is free to release the content's data once the game is unloaded
+    _ndsInfo = std::nullopt;
+    _gbaInfo = std::nullopt;
 }
 
 void MelonDsDs::CoreState::Run() noexcept {
@@ -145,6 +146,11 @@ void MelonDsDs::CoreState::Run() noexcept {
         ParseConfig(Config);
         ApplyConfig(Config);
         UpdateConsole(Config, nds);
+
+        if (_syncedClock) {
+            // Give the player a way to fix the emulated clock without restarting
+            _syncedClock->Resync();
+        }
     }
 
     if (!_ndsSramInstalled) [[unlikely]] {
@@ -154,8 +160,21 @@ void MelonDsDs::CoreState::Run() noexcept {
 
     if (_renderState.Ready()) [[likely]] {
         // If the global state needed for rendering is ready...
-        _inputState.Update(_screenLayout);
-        _inputState.Apply(nds, _screenLayout, _micState);
+        if (span<const std::byte> state = _movie.TakeStartState(); !state.empty()) [[unlikely]] {
+            // If the movie we're about to play starts from a savestate...
+            if (!LoadMovieStartState(nds, state)) {
+                _movie.Stop();
+            }
+        }
+
+        if (Config.LazyInputPolling()) {
+            // If we want to wait until the game actually reads its input...
+            _inputPending = true; // ...then the console will call OnInputRead when that happens.
+        }
+        else {
+            PollInput(nds);
+        }
+
         std::array<int16_t, 735> buffer {};
         _micState.Read(buffer);
         nds.MicInputFrame(buffer.data(), buffer.size());
@@ -175,24 +194,68 @@ void MelonDsDs::CoreState::Run() noexcept {
             _renderState.RequestRefresh();
         }
 
-        if (_syncClock) {
-            SetConsoleTime(nds, LocalTime());
+        if (_syncedClock) {
+            // If we're keeping the emulated RTC in sync with the host...
+            if (optional<local_seconds> now = _syncedClock->Tick()) {
+                // ...then we only need to update it when a new second starts.
+                SetConsoleTime(nds, *now);
+            }
+        }
+
+        if (_runAhead.Enabled() && PrepareRunAhead()) {
+            // If we want to hide some of the game's input lag...
+            RunAhead(nds, buffer);
         }
+        else {
+            // NDS::RunFrame renders the Nintendo DS state to a framebuffer,
+            // which is then drawn to the screen by Present
+            {
+                ZoneScopedN("NDS::RunFrame");
+                _renderState.RunFrame(nds);
+            }
 
-        // NDS::RunFrame renders the Nintendo DS state to a framebuffer,
-        // which is then drawn to the screen by _renderState.Render
-        {
-            ZoneScopedN("NDS::RunFrame");
-            nds.RunFrame();
+            Present(nds);
+            RenderAudio(*Console);
         }
 
-        _renderState.Render(nds, _inputState, Config, _screenLayout);
-        RenderAudio(*Console);
+        if (_inputPending) {
+            // If the game didn't read any input this frame (e.g. during a loading screen),
+            // we still need to poll it so that the frontend and the hotkeys keep working.
+            PollInput(nds);
+        }
 
         retro::task::check();
     }
 }
 
+void MelonDsDs::CoreState::Present(melonDS::NDS& nds) noexcept {
+    _renderState.Render(nds, _inputState, Config, _screenLayout);
+
+    if (_capture.IsActive()) [[unlikely]] {
+        // If we're recording the emulated screens...
+        _renderState.Capture(nds, _capture);
+        _capture.EndFrame();
+    }
+}
+
+void MelonDsDs::CoreState::PollInput(melonDS::NDS& nds) noexcept {
+    ZoneScopedN(TracyFunction);
+    _inputPending = false;
+    _inputPollScanline = nds.GPU.VCount;
+
+    _inputState.Update(_screenLayout);
+    if (optional<MovieFrame> frame = _movie.NextFrame()) {
+        // If we're playing back an input movie, its input replaces the player's
+        _inputState.Apply(nds, _screenLayout, _micState, *frame);
+    }
+    else {
+        _inputState.Apply(nds, _screenLayout, _micState);
+        if (_movie.IsRecording()) {
+            _movie.Record(_inputState.CaptureFrame(nds));
+        }
+    }
+}
+
 void MelonDsDs::CoreState::Reset() {
     ZoneScopedN(TracyFunction);
 
@@ -211,12 +274,14 @@ void MelonDsDs::CoreState::Reset() {
     }
     retro::task::check();
     _savestateSize = std::nullopt;
+    _runAhead.Clear();
 
     retro_assert(Console != nullptr);
     RegisterCoreOptions();
     ParseConfig(Config);
     ApplyConfig(Config);
-    _syncClock = Config.StartTimeMode() == StartTimeMode::Sync;
+    InitMovie();
+    InitSyncedClock();
 
     std::vector<uint8_t> ndsSram(Console->GetNDSSaveLength());
     if (Console->GetNDSSaveLength() && Console->GetNDSSave()) {
@@ -230,6 +295,15 @@ void MelonDsDs::CoreState::Reset() {
 
     std::vector<melonDS::ARCode> cheats = std::move(Console->AREngine.Cheats);
 
+    if (_ndsInfo && Console->ConsoleType == 1) {
+        const melonDS::NDSHeader& header = *reinterpret_cast<const melonDS::NDSHeader*>(_ndsInfo->GetData().data());
+        if (header.IsDSiWare()) {
+            // The NAND's changes are discarded along with the console,
+            // so save the game's data now; it'll be imported again when the title is reinstalled.
+            UninstallDsiware(static_cast<melonDS::DSi*>(Console.get())->GetNAND());
+        }
+    }
+
     Console = nullptr;
     melonDS::NDS::Current = nullptr;
     Console = CreateConsole(
@@ -286,6 +360,69 @@ void MelonDsDs::CoreState::RenderAudio(melonDS::NDS& nds) noexcept {
     retro::audio_sample_batch(audio_buffer, read);
 }
 
+void MelonDsDs::CoreState::DiscardAudio(melonDS::NDS& nds) noexcept {
+    ZoneScopedN(TracyFunction);
+    int16_t audio_buffer[0x1000];
+    uint32_t size = sizeof(audio_buffer) / (2 * sizeof(int16_t));
+
+    // Keep reading until the SPU's output buffer is empty
+    while (nds.SPU.GetOutputSize() > 0 && nds.SPU.ReadOutput(audio_buffer, size) > 0);
+}
+
+bool MelonDsDs::CoreState::PrepareRunAhead() noexcept {
+    if (static_cast<ConsoleType>(Console->ConsoleType) == ConsoleType::DSi) [[unlikely]] {
+        // Run-ahead relies on savestates, which DSi mode doesn't support right now
+        return false;
+    }
+
+    // SerializeSize only does the expensive dry run the first time it's called
+    size_t size = SerializeSize();
+    return size > 0 && _runAhead.Reserve(size);
+}
+
+// Works just like the frontend's single-instance run-ahead,
+// except the snapshot goes into a buffer that we reuse every frame.
+void MelonDsDs::CoreState::RunAhead(melonDS::NDS& nds, std::span<int16_t> micInput) noexcept {
+    ZoneScopedN(TracyFunction);
+
+    // The first frame is the one that really happens, so we keep its audio (but not its video)
+    {
+        ZoneScopedN("NDS::RunFrame");
+        _renderState.RunFrame(nds);
+    }
+    RenderAudio(nds);
+
+    if (_inputPending) {
+        // If the real frame didn't read any input, poll it now;
+        // otherwise a hidden frame would, and the rollback would lose it
+        PollInput(nds);
+    }
+
+    if (!_runAhead.Save(nds)) [[unlikely]] {
+        // If we couldn't take a snapshot, just show the frame we have
+        retro::warn("Failed to save the run-ahead snapshot, skipping run-ahead for this frame");
+        Present(nds);
+        return;
+    }
+
+    // Now run the hidden frames with the same input,
+    // and only present the last one
+    for (unsigned i = 0; i < _runAhead.Frames(); ++i) {
+        ZoneScopedN("NDS::RunFrame (run-ahead)");
+        nds.MicInputFrame(micInput.data(), micInput.size());
+        _renderState.RunFrame(nds);
+    }
+
+    Present(nds);
+
+    // The hidden frames' audio never happened as far as the player's concerned
+    DiscardAudio(nds);
+
+    if (!_runAhead.Load(nds)) [[unlikely]] {
+        retro::error("Failed to restore the run-ahead snapshot; the emulated console is now {} frames ahead", _runAhead.Frames());
+    }
+}
+
 bool MelonDsDs::CoreState::RunDeferredInitialization() noexcept {
     ZoneScopedN(TracyFunction);
     retro_assert(Console != nullptr);
@@ -374,22 +511,123 @@ void MelonDsDs::CoreState::InstallNdsSram() noexcept {
     _ndsSramInstalled = true;
 }
 
+void MelonDsDs::CoreState::InitSyncedClock() noexcept {
+    if (Config.StartTimeMode() == StartTimeMode::Sync && !_movie.IsActive()) {
+        // If we want the emulated RTC to follow the host's clock
+        // (and we're not recording or playing a movie, which needs a fixed clock)...
+        _syncedClock.emplace();
+    }
+    else {
+        _syncedClock = std::nullopt;
+    }
+}
+
+void MelonDsDs::CoreState::InitMovie() noexcept {
+    ZoneScopedN(TracyFunction);
+
+    _movie.Stop();
+    switch (Config.MovieMode()) {
+        case MovieMode::Record:
+            if (!StartMovieRecording({})) {
+                retro::set_error_message("Failed to start recording the input movie. See the log for details.");
+            }
+            break;
+        case MovieMode::Play: {
+            optional<string> path = GetMovieHostPath(_ndsInfo ? &*_ndsInfo : nullptr);
+            if (!path || !_movie.StartPlayback(*path)) {
+                retro::set_error_message("Failed to play the input movie. See the log for details.");
+            }
+            break;
+        }
+        case MovieMode::Disabled:
+            break;
+    }
+
+    ApplyMovieMicConfig();
+}
+
+// Starts or stops capturing frames if the option changed
+void MelonDsDs::CoreState::ApplyCaptureConfig(const CoreConfig& config) noexcept {
+    if (config.CaptureMode() == _capture.Mode())
+        return;
+
+    _renderState.StopCapture();
+    _capture.Stop();
+    if (config.CaptureMode() == CaptureMode::Disabled)
+        return;
+
+    optional<string> path = GetCaptureHostPath(_ndsInfo ? &*_ndsInfo : nullptr, config.CaptureMode());
+    if (!path || !_capture.Start(config.CaptureMode(), *path)) {
+        retro::set_error_message("Failed to start capturing frames. See the log for details.");
+    }
+}
+
+bool MelonDsDs::CoreState::StartMovieRecording(span<const std::byte> state) noexcept {
+    optional<string> path = GetMovieHostPath(_ndsInfo ? &*_ndsInfo : nullptr);
+    if (!path) {
+        retro::error("No save directory available, can't record a movie");
+        return false;
+    }
+
+    if (Config.MicInputMode() == MicInputMode::HostMic) {
+        retro::warn("Audio from the host microphone won't be recorded; playback will use silence instead");
+    }
+
+    MovieHeader header;
+    header.MicInputMode = Config.MicInputMode();
+    header.MicButtonMode = Config.MicButtonMode();
+    header.StartTime = Config.AbsoluteStartDateTime().time_since_epoch().count();
+
+    return _movie.StartRecording(*path, header, state);
+}
+
+void MelonDsDs::CoreState::ApplyMovieMicConfig() noexcept {
+    if (!_movie.IsPlaying())
+        return;
+
+    // The movie's microphone settings take precedence over the player's,
+    // but we can't replay the host microphone's audio
+    const MovieHeader& header = _movie.Header();
+    _micState.SetMicInputMode(header.MicInputMode == MicInputMode::HostMic ? MicInputMode::None : header.MicInputMode);
+    _micState.SetMicButtonMode(header.MicButtonMode);
+}
+
+bool MelonDsDs::CoreState::LoadMovieStartState(melonDS::NDS& nds, span<const std::byte> state) noexcept {
+    ZoneScopedN(TracyFunction);
+
+    melonDS::Savestate savestate(const_cast<void*>(static_cast<const void*>(state.data())), state.size(), false);
+    if (savestate.Error || !nds.DoSavestate(&savestate) || savestate.Error) {
+        retro::error("Failed to load the movie's {}-byte starting savestate", state.size());
+        retro::set_error_message("This movie's savestate couldn't be loaded, most likely the ROM or the core is wrong.");
+        return false;
+    }
+
+    return true;
+}
+
 void MelonDsDs::CoreState::SetConsoleTime(melonDS::NDS& nds) noexcept {
     ZoneScopedN(TracyFunction);
 
-    local_seconds now = LocalTime();
     local_seconds targetTime;
 
+    if (_movie.IsActive()) {
+        // If we're recording or playing a movie, the emulated clock must start at the same time in every run
+        targetTime = local_seconds(seconds(_movie.Header().StartTime));
+        retro::debug("Starting the RTC at {:%F %r} (movie)", ToSystemTime(targetTime));
+        SetConsoleTime(nds, targetTime);
+        return;
+    }
+
     switch (Config.StartTimeMode()) {
         case StartTimeMode::Sync:
         case StartTimeMode::Real: {
-            targetTime = now;
+            targetTime = LocalTime();
             retro::debug("Starting the RTC at {:%F %r} (local time)", ToSystemTime(targetTime));
             break;
         }
         case StartTimeMode::Relative: {
             minutes offset = Config.RelativeDateTimeOffset();
-            targetTime = now + offset;
+            targetTime = LocalTime() + offset;
             retro::debug("Starting the RTC at {:%F %r} ({}y, {}, {}, {} from now)",
                 ToSystemTime(targetTime),
                 Config.RelativeYearOffset().count(),
@@ -400,13 +638,20 @@ void MelonDsDs::CoreState::SetConsoleTime(melonDS::NDS& nds) noexcept {
             break;
         }
         case StartTimeMode::Absolute: {
-            const auto tpm = floor<seconds>(now);
+            const auto tpm = floor<seconds>(LocalTime());
             const auto dp = floor<days>(tpm);
             auto time = make_time(tpm-dp);
             targetTime = Config.AbsoluteStartDateTime() + time.seconds();
             retro::debug("Starting the RTC at {:%F %r} (ignoring the local time)", ToSystemTime(targetTime));
             break;
         }
+        case StartTimeMode::Fixed: {
+            // Don't even look at the host's clock,
+            // so that every boot starts at exactly the same moment
+            targetTime = Config.AbsoluteStartDateTime();
+            retro::debug("Starting the RTC at {:%F %r} (fixed)", ToSystemTime(targetTime));
+            break;
+        }
     }
 
     SetConsoleTime(nds, targetTime);
@@ -515,7 +760,8 @@ bool MelonDsDs::CoreState::LoadGame(unsigned type, std::span<const retro_game_in
     }
     ApplyConfig(Config);
 
-    _syncClock = Config.StartTimeMode() == StartTimeMode::Sync;
+    InitMovie();
+    InitSyncedClock();
     retro_assert(Console == nullptr);
     // Instantiates the console with games and save data installed
     Console = CreateConsole(
@@ -535,6 +781,11 @@ bool MelonDsDs::CoreState::LoadGame(unsigned type, std::span<const retro_game_in
         // DSi mode should've been forced if loading a DSiWare game
         InitNdsSave(*Console->GetNDSCart());
     }
+    else if (_ndsInfo && reinterpret_cast<const melonDS::NDSHeader*>(_ndsInfo->GetData().data())->IsDSiWare()) {
+        // If we installed a DSiWare game on the NAND...
+        retro::task::push(FlushDsiwareSaveDataTask()); // ...then export its save data whenever it changes.
+        retro::debug("Started DSiWare save data flush task.");
+    }
 
     if (_gbaInfo && _gbaSaveInfo && Console->GetGBASave() && Console->GetGBASaveLength()) {
         // If we inserted a GBA ROM with SRAM...
@@ -614,22 +865,34 @@ void MelonDsDs::CoreState::UninstallDsiware(melonDS::DSi_NAND::NANDImage& nand)
 
     if (!_ndsInfo) return;
 
+    // If the title was only installed for this session, then the NAND was opened copy-on-write,
+    // so the title (and every other change) is discarded when it's closed.
+    // Only the save data needs to be kept.
+    FlushDsiwareSaveData(nand);
+    _timeToDsiwareFlush = std::nullopt;
+}
+
+// Copies the loaded DSiWare title's save data from the NAND to the save directory
+void MelonDsDs::CoreState::FlushDsiwareSaveData(melonDS::DSi_NAND::NANDImage& nand) noexcept {
+    ZoneScopedN(TracyFunction);
+
+    if (!_ndsInfo) return;
+
     retro_assert(nand);
 
     const auto& header = *reinterpret_cast<const melonDS::NDSHeader*>(_ndsInfo->GetData().data());
     retro_assert(header.IsDSiWare());
 
+    // Make sure the NAND image itself is up-to-date too, in case it was opened read-write
+    FlushOpenFiles();
+
     if (NANDMount mount = NANDMount(nand)) {
         // TODO: Report an error if the title doesn't exist
-        // TODO: Only delete the title if the sentinel exists
         ExportDsiwareSaveData(mount, *_ndsInfo, header, TitleData_PublicSav);
         ExportDsiwareSaveData(mount, *_ndsInfo, header, TitleData_PrivateSav);
         ExportDsiwareSaveData(mount, *_ndsInfo, header, TitleData_BannerSav);
-
-        mount.DeleteTitle(header.DSiTitleIDHigh, header.DSiTitleIDLow);
-        retro::info("Removed temporarily-installed DSiWare title \"{}\" from NAND image", _ndsInfo->GetPath());
     } else {
-        retro::error("Failed to open DSi NAND for uninstallation");
+        retro::error("Failed to open DSi NAND to export DSiWare save data");
     }
 }
 
@@ -675,7 +938,12 @@ void MelonDsDs::CoreState::ApplyConfig(const CoreConfig& config) noexcept {
     _screenLayout.Apply(config, _renderState);
     _inputState.SetConfig(config);
     _micState.SetConfig(config);
+    ApplyMovieMicConfig();
     _netState.Apply(config);
+    _runAhead.SetConfig(config);
+    ApplyCaptureConfig(config);
+    SetThreadPolicy(config.ThreadAffinity(), config.ThreadPriority());
+    ApplyEmulationThreadPolicy();
     _screenLayout.SetDirty();
 
     if (oldMicInputMode != MicInputMode::HostMic && config.MicInputMode() == MicInputMode::HostMic) {
@@ -714,6 +982,9 @@ void MelonDsDs::CoreState::ApplyConfig(const CoreConfig& config) noexcept {
 void MelonDsDs::CoreState::InitContent(unsigned type, std::span<const retro_game_info> game) {
     ZoneScopedN(TracyFunction);
 
+    // Tells us whether we can use the frontend's copy of the content instead of making our own
+    const retro_game_info_ext* ext = game.empty() ? nullptr : retro::get_game_info_ext();
+
     // First initialize the content info...
     switch (type) {
         case MELONDSDS_GAME_TYPE_SLOT_1_2_BOOT:
@@ -726,8 +997,10 @@ void MelonDsDs::CoreState::InitContent(unsigned type, std::span<const retro_game
         case MELONDSDS_GAME_TYPE_SLOT_1_2_BOOT_NO_SRAM:
             if (game.size() > 1) {
                 // If we got a GBA ROM...
-                retro_assert(game[1].data != nullptr);
-                _gbaInfo = game[1];
+                _gbaInfo.emplace(game[1], ext ? &ext[1] : nullptr);
+                if (_gbaInfo->GetData().empty()) {
+                    throw content_exception("Failed to load the GBA ROM, the frontend may have a bug.");
+                }
             }
 
             [[fallthrough]];
@@ -742,15 +1015,15 @@ void MelonDsDs::CoreState::InitContent(unsigned type, std::span<const retro_game
                     throw content_exception("Loaded a save file instead of a ROM, ensure that you opened the right file.");
                 }
 
-                if (game[0].size == 0) {
-                    throw content_exception("Loaded an empty file as content, please load a valid Nintendo DS ROM.");
-                }
-
-                if (game[0].data == nullptr) {
+                if (game[0].data == nullptr && game[0].path == nullptr) {
                     throw content_exception("Failed to load the content data, the frontend may have a bug.");
                 }
 
-                _ndsInfo = game[0];
+                // The frontend may keep the ROM in memory for us, or it may only give us its path
+                _ndsInfo.emplace(game[0], ext ? &ext[0] : nullptr);
+                if (_ndsInfo->GetData().empty()) {
+                    throw content_exception("Loaded an empty file as content, please load a valid Nintendo DS ROM.");
+                }
             }
             break;
         default:
@@ -822,6 +1095,10 @@ bool MelonDsDs::CoreState::Serialize(std::span<std::byte> data) const noexcept {
 
     retro_assert(Console != nullptr);
 
+    // The NAND and SD card images aren't part of the savestate,
+    // so make sure they're up-to-date on disk when it's taken
+    FlushOpenFiles();
+
 #ifndef NDEBUG
     if (_ndsInfo) {
         // If we're booting with a ROM...
@@ -915,7 +1192,28 @@ bool MelonDsDs::CoreState::Unserialize(std::span<const std::byte> data) noexcept
         return false;
     }
 
-    return Console->DoSavestate(&savestate) && !savestate.Error;
+    if (!Console->DoSavestate(&savestate) || savestate.Error) {
+        return false;
+    }
+
+    if (_syncedClock) {
+        // The savestate brought its own RTC time with it, so we need to overwrite it
+        _syncedClock->Resync();
+    }
+
+    if (_movie.IsRecording()) {
+        // If the player loaded a state while recording a movie,
+        // then the movie starts over from this state
+        if (!StartMovieRecording(data)) {
+            retro::set_error_message("Failed to restart the input movie. See the log for details.");
+        }
+    }
+    else if (_movie.IsPlaying()) {
+        retro::warn("Loaded a savestate during movie playback; stopping playback");
+        _movie.Stop();
+    }
+
+    return true;
 }
 
 std::byte* MelonDsDs::CoreState::GetMemoryData(unsigned id) noexcept {
@@ -28,6 +28,7 @@
 #include "../config/visibility.hpp"
 #include "../message/error.hpp"
 #include "../microphone.hpp"
+#include "../render/capture.hpp"
 #include "../render/render.hpp"
 #include "../retro/info.hpp"
 #include "../screenlayout.hpp"
@@ -35,6 +36,8 @@
 #include "../sram.hpp"
 #include "net/net.hpp"
 #include "net/mp.hpp"
+#include "clock.hpp"
+#include "runahead.hpp"
 #include "std/span.hpp"
 
 struct retro_game_info;
@@ -105,26 +108,53 @@ namespace MelonDsDs {
         bool UpdateOptionVisibility() noexcept;
 
         const melonDS::NDS* GetConsole() const noexcept { return Console.get(); }
+        melonDS::NDS* GetConsole() noexcept { return Console.get(); }
+        [[nodiscard]] const retro::GameInfo* GetNdsInfo() const noexcept { return _ndsInfo ? &*_ndsInfo : nullptr; }
         [[nodiscard]] const InputState& GetInputState() const noexcept { return _inputState; }
         [[nodiscard]] InputState& GetInputState() noexcept { return _inputState; }
         std::optional<RenderMode> GetRenderMode() const noexcept { return _renderState.GetRenderMode(); }
         const ScreenLayoutData& GetScreenLayoutData() const noexcept { return _screenLayout; }
+        [[nodiscard]] RenderStats GetRenderStats() const noexcept { return _renderState.Stats(); }
+        [[nodiscard]] const FrameCaptureState& GetCaptureState() const noexcept { return _capture; }
+
+        /// The scanline the emulated console was on when the frontend's input was last polled.
+        [[nodiscard]] uint16_t InputPollScanline() const noexcept { return _inputPollScanline; }
+
+        /// Called by the emulated console when the game reads the keypad, lid, or touch screen.
+        /// If late input polling is enabled, the first such read in each frame polls the frontend's input.
+        [[gnu::hot]] void OnInputRead(melonDS::NDS& nds) noexcept {
+            if (_inputPending) [[unlikely]] {
+                PollInput(nds);
+            }
+        }
     private:
         static constexpr auto REGEX_OPTIONS = std::regex_constants::ECMAScript | std::regex_constants::optimize;
         [[gnu::cold]] void ApplyConfig(const CoreConfig& config) noexcept;
         [[gnu::cold]] bool RunDeferredInitialization() noexcept;
         [[gnu::cold]] void InstallNdsSram() noexcept;
         [[gnu::cold]] void StartConsole();
+        [[gnu::cold]] void InitSyncedClock() noexcept;
+        [[gnu::cold]] void InitMovie() noexcept;
+        [[gnu::cold]] bool StartMovieRecording(std::span<const std::byte> state) noexcept;
+        [[gnu::cold]] void ApplyMovieMicConfig() noexcept;
+        [[gnu::cold]] void ApplyCaptureConfig(const CoreConfig& config) noexcept;
+        [[gnu::cold]] bool LoadMovieStartState(melonDS::NDS& nds, std::span<const std::byte> state) noexcept;
         [[gnu::cold]] void SetConsoleTime(melonDS::NDS& nds) noexcept;
         [[gnu::cold]] void SetConsoleTime(melonDS::NDS& nds, local_seconds time) noexcept;
         [[gnu::cold]] void UninstallDsiware(melonDS::DSi_NAND::NANDImage& nand) noexcept;
+        [[gnu::cold]] void FlushDsiwareSaveData(melonDS::DSi_NAND::NANDImage& nand) noexcept;
         [[gnu::cold]] static void ExportDsiwareSaveData(
             melonDS::DSi_NAND::NANDMount& nand,
             const retro::GameInfo& nds_info,
             const melonDS::NDSHeader& header,
             int type
         ) noexcept;
+        [[gnu::hot]] void PollInput(melonDS::NDS& nds) noexcept;
+        [[gnu::hot]] void Present(melonDS::NDS& nds) noexcept;
         [[gnu::hot]] static void RenderAudio(melonDS::NDS& nds) noexcept;
+        [[gnu::hot]] static void DiscardAudio(melonDS::NDS& nds) noexcept;
+        [[gnu::hot]] bool PrepareRunAhead() noexcept;
+        [[gnu::hot]] void RunAhead(melonDS::NDS& nds, std::span<int16_t> micInput) noexcept;
         [[gnu::cold]] bool InitErrorScreen(const config_exception& e) noexcept;
         [[gnu::cold]] void RenderErrorScreen() noexcept;
         [[gnu::cold]] void InitContent(unsigned type, std::span<const retro_game_info> game);
@@ -136,6 +166,7 @@ namespace MelonDsDs {
         retro::task::TaskSpec FlushGbaSramTask() noexcept;
         void FlushGbaSram(const retro::GameInfo& gbaSaveInfo) noexcept;
         retro::task::TaskSpec FlushFirmwareTask(string_view firmwareName) noexcept;
+        retro::task::TaskSpec FlushDsiwareSaveDataTask() noexcept;
         void InitFlushFirmwareTask() noexcept;
         void FlushFirmware(string_view firmwarePath, string_view wfcSettingsPath) noexcept;
         [[gnu::cold]] void InitNdsSave(const NdsCart &nds_cart);
@@ -149,6 +180,9 @@ namespace MelonDsDs {
         MicrophoneState _micState {};
         RenderStateWrapper _renderState {};
         MpState _mpState {};
+        RunAheadState _runAhead {};
+        MovieState _movie {};
+        FrameCaptureState _capture {};
         std::optional<retro::GameInfo> _ndsInfo = std::nullopt;
         std::optional<retro::GameInfo> _gbaInfo = std::nullopt;
         std::optional<retro::GameInfo> _gbaSaveInfo = std::nullopt;
@@ -156,8 +190,9 @@ namespace MelonDsDs {
         std::optional<sram::SaveManager> _gbaSaveManager = std::nullopt;
         std::optional<int> _timeToGbaFlush = std::nullopt;
         std::optional<int> _timeToFirmwareFlush = std::nullopt;
+        std::optional<int> _timeToDsiwareFlush = std::nullopt;
         mutable std::optional<size_t> _savestateSize = std::nullopt;
-        bool _syncClock = false;
+        std::optional<SyncedClock> _syncedClock = std::nullopt;
         std::unique_ptr<error::ErrorScreen> _messageScreen = nullptr;
         // TODO: Switch to compile time regular expressions (see https://compile-time.re)
         std::regex _cheatSyntax { "^\\s*[0-9A-Fa-f]{8}([+\\s-]*[0-9A-Fa-f]{8})*$", REGEX_OPTIONS };
@@ -168,6 +203,8 @@ namespace MelonDsDs {
         const bool _initialized = true;
         bool _ndsSramInstalled = false;
         bool _deferredInitializationPending = false;
+        bool _inputPending = false;
+        uint16_t _inputPollScanline = 0;
         uint32_t _flushTaskId = 0;
     };
 }
@@ -0,0 +1,83 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "runahead.hpp"
+
+#include <new>
+
+#include <NDS.h>
+#include <Savestate.h>
+
+#include "config/config.hpp"
+#include "environment.hpp"
+#include "tracy.hpp"
+
+void MelonDsDs::RunAheadState::SetConfig(const CoreConfig& config) noexcept {
+    if (_frames != config.RunAheadFrames()) {
+        retro::debug("Run-ahead changed from {} to {} frames", _frames, config.RunAheadFrames());
+    }
+
+    _frames = config.RunAheadFrames();
+
+    if (_frames == 0) {
+        // No need to hang onto several megabytes we're not going to use
+        Clear();
+    }
+}
+
+bool MelonDsDs::RunAheadState::Reserve(size_t size) noexcept {
+    if (_buffer && _size == size) [[likely]] {
+        // If we already have a buffer of the right size...
+        return true;
+    }
+
+    ZoneScopedN(TracyFunction);
+    _buffer.reset(new(std::nothrow) std::byte[size]);
+    if (!_buffer) {
+        retro::error("Failed to allocate a {}-byte run-ahead buffer", size);
+        _size = 0;
+        return false;
+    }
+
+    _size = size;
+    retro::debug("Allocated a {}-byte run-ahead buffer", size);
+    return true;
+}
+
+bool MelonDsDs::RunAheadState::Save(melonDS::NDS& nds) noexcept {
+    ZoneScopedN(TracyFunction);
+    if (!_buffer) return false;
+
+    melonDS::Savestate state(_buffer.get(), _size, true);
+    return nds.DoSavestate(&state) && !state.Error;
+}
+
+bool MelonDsDs::RunAheadState::Load(melonDS::NDS& nds) noexcept {
+    ZoneScopedN(TracyFunction);
+    if (!_buffer) return false;
+
+    melonDS::Savestate state(_buffer.get(), _size, false);
+    if (state.Error) {
+        return false;
+    }
+
+    return nds.DoSavestate(&state) && !state.Error;
+}
+
+void MelonDsDs::RunAheadState::Clear() noexcept {
+    _buffer = nullptr;
+    _size = 0;
+}
@@ -0,0 +1,53 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MELONDSDS_RUNAHEAD_HPP
+#define MELONDSDS_RUNAHEAD_HPP
+
+#include <cstddef>
+#include <memory>
+
+namespace melonDS {
+    class NDS;
+}
+
+namespace MelonDsDs {
+    class CoreConfig;
+
+    /// Holds the snapshot that the core rolls back to after running ahead.
+    /// The buffer is allocated once (when the savestate size is first known)
+    /// and reused every frame, unlike the frontend's run-ahead
+    /// which goes through retro_serialize and retro_unserialize.
+    class RunAheadState {
+    public:
+        void SetConfig(const CoreConfig& config) noexcept;
+        [[nodiscard]] unsigned Frames() const noexcept { return _frames; }
+        [[nodiscard]] bool Enabled() const noexcept { return _frames > 0; }
+
+        /// Ensures the snapshot buffer can hold a savestate of the given size.
+        /// @returns \c false if the buffer couldn't be allocated.
+        bool Reserve(size_t size) noexcept;
+        [[gnu::hot]] bool Save(melonDS::NDS& nds) noexcept;
+        [[gnu::hot]] bool Load(melonDS::NDS& nds) noexcept;
+        void Clear() noexcept;
+    private:
+        std::unique_ptr<std::byte[]> _buffer = nullptr;
+        size_t _size = 0;
+        unsigned _frames = 0;
+    };
+}
+
+#endif //MELONDSDS_RUNAHEAD_HPP
@@ -32,6 +32,7 @@
 #include "core.hpp"
 #include "environment.hpp"
 #include "microphone.hpp"
+#include "platform/file.hpp"
 #include "retro/task_queue.hpp"
 #include "tracy.hpp"
 
@@ -296,6 +297,41 @@ retro::task::TaskSpec MelonDsDs::CoreState::FlushFirmwareTask(string_view firmwa
     );
 }
 
+// Exports DSiWare save data some time after the game last wrote to the NAND,
+// so that it survives even if the session ends without the game being unloaded.
+retro::task::TaskSpec MelonDsDs::CoreState::FlushDsiwareSaveDataTask() noexcept {
+    ZoneScopedN(TracyFunction);
+    return {
+        [this, lastWrites=GetFileStats().Writes](retro::task::TaskHandle &task) mutable noexcept {
+            if (!_ndsInfo || Console == nullptr || Console->ConsoleType != 1) {
+                task.Finish();
+                return;
+            }
+
+            if (uint64_t writes = GetFileStats().Writes; writes != lastWrites) {
+                // melonDS doesn't say which file it wrote to, but DSiWare saves to the NAND
+                // (and exporting after the occasional SD card write too is harmless).
+                // The timer resets every time the game writes,
+                // so that saving a file doesn't result in an export for every sector.
+                lastWrites = writes;
+                _timeToDsiwareFlush = Config.FlushDelay();
+            }
+
+            if (_timeToDsiwareFlush != nullopt && (*_timeToDsiwareFlush)-- <= 0) {
+                // If it's time to export the save data...
+                retro::debug("DSiWare save data flush timer expired, exporting save data now");
+                FlushDsiwareSaveData(static_cast<DSi*>(Console.get())->GetNAND());
+                _timeToDsiwareFlush = nullopt; // Reset the timer
+                lastWrites = GetFileStats().Writes; // Don't count the export's own writes
+            }
+        },
+        nullptr,
+        nullptr,
+        retro::task::ASAP,
+        "DSiWare Save Data Flush"
+    };
+}
+
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "readability-function-cognitive-complexity"
 retro::task::TaskSpec MelonDsDs::CoreState::OnScreenDisplayTask() noexcept {
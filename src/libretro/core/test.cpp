@@ -16,10 +16,19 @@
 
 #include "test.hpp"
 
+#include <vector>
+
+#include <DSi.h>
+#include <DSi_NAND.h>
+#include <streams/file_stream.h>
 #include <string/stdstring.h>
 
 #include "core.hpp"
+#include "config/sysfiles.hpp"
 #include "environment.hpp"
+#include "libretro.hpp"
+#include "platform/file.hpp"
+#include "std/chrono.hpp"
 
 namespace MelonDsDs
 {
@@ -224,6 +233,168 @@ extern "C" unsigned melondsds_get_controller_port_device(unsigned port) noexcept
     return Core.GetInputState().GetControllerPortDevice(port);
 }
 
+extern "C" uint16_t melondsds_input_poll_scanline() noexcept {
+    return MelonDsDs::Core.InputPollScanline();
+}
+
+extern "C" uint64_t melondsds_render_frames_presented() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().FramesPresented;
+}
+
+extern "C" uint64_t melondsds_render_uniform_uploads() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().UniformUploads;
+}
+
+extern "C" uint64_t melondsds_render_texture_parameter_updates() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().TextureParameterUpdates;
+}
+
+extern "C" uint32_t melondsds_render_shader_cache_hits() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().ShaderCacheHits;
+}
+
+extern "C" uint32_t melondsds_render_shader_cache_misses() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().ShaderCacheMisses;
+}
+
+extern "C" uint32_t melondsds_render_context_resets() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().ContextResets;
+}
+
+extern "C" uint32_t melondsds_render_context_reuses() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().ContextReuses;
+}
+
+// Calls the core's context_reset callback the way a frontend does
+// when it reinitializes its video driver but keeps our context alive
+// (i.e. without calling context_destroy first).
+extern "C" void melondsds_render_simulate_context_reset() noexcept {
+    MelonDsDs::HardwareContextReset();
+}
+
+extern "C" uint64_t melondsds_render_context_reset_to_first_frame_us() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().ContextResetToFirstFrameMicroseconds;
+}
+
+extern "C" uint64_t melondsds_render_gpu_emulation_ns() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().GpuEmulationNanoseconds;
+}
+
+extern "C" uint64_t melondsds_render_gpu_presentation_ns() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetRenderStats().GpuPresentationNanoseconds;
+}
+
+extern "C" uint64_t melondsds_capture_frames_written() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetCaptureState().FramesWritten();
+}
+
+extern "C" uint64_t melondsds_capture_frames_dropped() noexcept {
+    using namespace MelonDsDs;
+
+    return Core.GetCaptureState().FramesDropped();
+}
+
+extern "C" uint64_t melondsds_file_operations() noexcept {
+    const MelonDsDs::FileStats& stats = MelonDsDs::GetFileStats();
+
+    return stats.Reads + stats.Writes;
+}
+
+extern "C" uint64_t melondsds_file_vfs_operations() noexcept {
+    const MelonDsDs::FileStats& stats = MelonDsDs::GetFileStats();
+
+    return stats.VfsReads + stats.VfsWrites;
+}
+
+extern "C" uint64_t melondsds_file_mapped_files() noexcept {
+    return MelonDsDs::GetFileStats().MappedFiles;
+}
+
+extern "C" uint64_t melondsds_file_overlay_sectors() noexcept {
+    return MelonDsDs::GetFileStats().OverlaySectors;
+}
+
+extern "C" uint64_t melondsds_file_skipped_zero_bytes() noexcept {
+    return MelonDsDs::GetFileStats().SkippedZeroBytes;
+}
+
+// Overwrites the loaded DSiWare title's public save data on the NAND with the given byte,
+// like the game itself would when saving.
+// Returns false if no DSiWare title is loaded or it doesn't use public save data.
+extern "C" bool melondsds_dsiware_fill_public_save(uint8_t value) noexcept {
+    using namespace MelonDsDs;
+    using namespace melonDS::DSi_NAND;
+
+    melonDS::NDS* nds = Core.GetConsole();
+    const retro::GameInfo* ndsInfo = Core.GetNdsInfo();
+    if (!nds || nds->ConsoleType != 1 || !ndsInfo)
+        return false;
+
+    const auto& header = *reinterpret_cast<const melonDS::NDSHeader*>(ndsInfo->GetData().data());
+    if (!header.IsDSiWare() || header.DSiPublicSavSize == 0)
+        return false;
+
+    // NANDMount can only import title data from a file
+    std::optional<std::string> path = retro::get_save_subdir_path("dsiware_fill.sav");
+    std::vector<uint8_t> data(header.DSiPublicSavSize, value);
+    if (!path || !filestream_write_file(path->c_str(), data.data(), data.size()))
+        return false;
+
+    bool ok = false;
+    if (NANDMount mount = NANDMount(static_cast<melonDS::DSi*>(nds)->GetNAND())) {
+        ok = mount.ImportTitleData(header.DSiTitleIDHigh, header.DSiTitleIDLow, TitleData_PublicSav, path->c_str());
+    }
+
+    filestream_delete(path->c_str());
+    return ok;
+}
+
+// Returns the emulated RTC's date and time as seconds since 1970-01-01 in local time,
+// or -1 if there's no console.
+extern "C" int64_t melondsds_rtc_time() noexcept {
+    using namespace MelonDsDs;
+    using namespace std::chrono;
+    melonDS::NDS* console = Core.GetConsole();
+    if (!console)
+        return -1;
+
+    int y = 0, mo = 0, d = 0, h = 0, mi = 0, s = 0;
+    console->RTC.GetDateTime(y, mo, d, h, mi, s);
+
+    local_seconds time = local_days(year(y) / month(mo) / day(d)) + hours(h) + minutes(mi) + seconds(s);
+    return time.time_since_epoch().count();
+}
+
+extern "C" uint64_t melondsds_sysfile_index_hits() noexcept {
+    return MelonDsDs::config::GetSystemFileIndexStats().Hits;
+}
+
+extern "C" uint64_t melondsds_sysfile_index_misses() noexcept {
+    return MelonDsDs::config::GetSystemFileIndexStats().Misses;
+}
+
 extern "C" retro_proc_address_t MelonDsDs::GetRetroProcAddress(const char* sym) noexcept {
     if (string_is_equal(sym, "libretropy_add_integers"))
         return reinterpret_cast<retro_proc_address_t>(libretropy_add_integers);
@@ -306,6 +477,75 @@ extern "C" retro_proc_address_t MelonDsDs::GetRetroProcAddress(const char* sym)
     if (string_is_equal(sym, "melondsds_get_controller_port_device"))
         return reinterpret_cast<retro_proc_address_t>(melondsds_get_controller_port_device);
 
+    if (string_is_equal(sym, "melondsds_input_poll_scanline"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_input_poll_scanline);
+
+    if (string_is_equal(sym, "melondsds_render_frames_presented"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_frames_presented);
+
+    if (string_is_equal(sym, "melondsds_render_uniform_uploads"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_uniform_uploads);
+
+    if (string_is_equal(sym, "melondsds_render_texture_parameter_updates"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_texture_parameter_updates);
+
+    if (string_is_equal(sym, "melondsds_render_shader_cache_hits"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_shader_cache_hits);
+
+    if (string_is_equal(sym, "melondsds_render_shader_cache_misses"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_shader_cache_misses);
+
+    if (string_is_equal(sym, "melondsds_render_context_resets"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_context_resets);
+
+    if (string_is_equal(sym, "melondsds_render_context_reuses"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_context_reuses);
+
+    if (string_is_equal(sym, "melondsds_render_simulate_context_reset"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_simulate_context_reset);
+
+    if (string_is_equal(sym, "melondsds_render_context_reset_to_first_frame_us"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_context_reset_to_first_frame_us);
+
+    if (string_is_equal(sym, "melondsds_render_gpu_emulation_ns"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_gpu_emulation_ns);
+
+    if (string_is_equal(sym, "melondsds_render_gpu_presentation_ns"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_render_gpu_presentation_ns);
+
+    if (string_is_equal(sym, "melondsds_capture_frames_written"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_capture_frames_written);
+
+    if (string_is_equal(sym, "melondsds_capture_frames_dropped"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_capture_frames_dropped);
+
+    if (string_is_equal(sym, "melondsds_file_operations"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_file_operations);
+
+    if (string_is_equal(sym, "melondsds_file_vfs_operations"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_file_vfs_operations);
+
+    if (string_is_equal(sym, "melondsds_file_mapped_files"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_file_mapped_files);
+
+    if (string_is_equal(sym, "melondsds_file_overlay_sectors"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_file_overlay_sectors);
+
+    if (string_is_equal(sym, "melondsds_file_skipped_zero_bytes"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_file_skipped_zero_bytes);
+
+    if (string_is_equal(sym, "melondsds_dsiware_fill_public_save"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_dsiware_fill_public_save);
+
+    if (string_is_equal(sym, "melondsds_rtc_time"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_rtc_time);
+
+    if (string_is_equal(sym, "melondsds_sysfile_index_hits"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_sysfile_index_hits);
+
+    if (string_is_equal(sym, "melondsds_sysfile_index_misses"))
+        return reinterpret_cast<retro_proc_address_t>(melondsds_sysfile_index_misses);
+
     return nullptr;
 }
 
@@ -308,6 +308,12 @@ std::optional<std::chrono::microseconds> retro::last_frame_time() noexcept {
     return _lastFrameTime;
 }
 
+const retro_game_info_ext* retro::get_game_info_ext() noexcept {
+    const retro_game_info_ext* ext = nullptr;
+    bool ok = environment(RETRO_ENVIRONMENT_GET_GAME_INFO_EXT, &ext);
+    return ok ? ext : nullptr;
+}
+
 bool retro::is_variable_updated() noexcept {
     ZoneScopedN(TracyFunction);
 
@@ -124,6 +124,11 @@ namespace retro {
     std::optional<retro_throttle_state> get_throttle_state() noexcept;
     std::optional<std::chrono::microseconds> last_frame_time() noexcept;
 
+    /// Returns the frontend's extended info for each piece of loaded content,
+    /// or nullptr if it doesn't provide any.
+    /// Only valid during retro_load_game or retro_load_game_special.
+    const retro_game_info_ext* get_game_info_ext() noexcept;
+
     std::optional<std::string_view> get_save_directory() noexcept;
     std::optional<std::string_view> get_save_subdirectory() noexcept;
     std::optional<std::string> get_save_path(std::string_view name) noexcept;
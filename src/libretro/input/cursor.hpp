@@ -46,6 +46,8 @@ namespace MelonDsDs {
         [[nodiscard]] glm::ivec2 JoypadTouchPosition() const noexcept { return _joystickCursorPosition; }
         [[nodiscard]] glm::ivec2 PointerTouchPosition() const noexcept { return _pointerCursorPosition; }
         [[nodiscard]] bool IsTouching() const noexcept;
+        /// The touch position most recently forwarded to the emulated DS, in NDS pixel coordinates
+        [[nodiscard]] glm::uvec2 ConsoleTouchPosition() const noexcept { return _consoleTouchPosition; }
         [[nodiscard]] bool TouchReleased() const noexcept { return _isTouchReleased; }
         [[nodiscard]] bool CursorVisible() const noexcept;
     private:
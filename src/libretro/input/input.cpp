@@ -38,6 +38,7 @@
 #include "utils.hpp"
 
 using MelonDsDs::InputState;
+using MelonDsDs::MovieFrame;
 using glm::ivec2;
 using glm::ivec3;
 using glm::i16vec2;
@@ -150,6 +151,57 @@ void InputState::Apply(melonDS::NDS& nds, ScreenLayoutData& layout, MicrophoneSt
     _cursor.Apply(nds);
 }
 
+void InputState::Apply(melonDS::NDS& nds, ScreenLayoutData& layout, MicrophoneState& mic, const MovieFrame& frame) const noexcept {
+    ZoneScopedN(TracyFunction);
+
+    // The screen layout isn't part of the emulated console, so the player can still change it
+    _joypad.Apply(layout);
+
+    nds.SetKeyMask(frame.Keys);
+
+    if (frame.Has(MovieFrame::LidClosed) != nds.IsLidClosed()) {
+        // If the lid was opened or closed on this frame of the recording...
+        nds.SetLidClosed(frame.Has(MovieFrame::LidClosed));
+    }
+
+    mic.SetMicButtonState(frame.Has(MovieFrame::MicButton));
+
+    std::optional<uint8_t> lightLevel = frame.Has(MovieFrame::HasLightLevel) ? std::make_optional(frame.LightLevel) : std::nullopt;
+    SolarSensorState::Apply(nds, lightLevel, frame.Has(MovieFrame::LightLevelUp), frame.Has(MovieFrame::LightLevelDown));
+
+    if (frame.Has(MovieFrame::Touching)) {
+        nds.TouchScreen(frame.TouchX, frame.TouchY);
+    } else if (frame.Has(MovieFrame::TouchReleased)) {
+        nds.ReleaseScreen();
+    }
+}
+
+MovieFrame InputState::CaptureFrame(const melonDS::NDS& nds) const noexcept {
+    MovieFrame frame;
+    frame.Keys = _joypad.ConsoleButtons() & 0xFFF;
+    frame.Set(MovieFrame::LidClosed, nds.IsLidClosed());
+    frame.Set(MovieFrame::MicButton, _joypad.MicButtonDown());
+
+    if (const auto* solar = get_if<SolarSensorState>(&_slot2)) {
+        std::optional<uint8_t> lightLevel = solar->LightLevel();
+        frame.Set(MovieFrame::HasLightLevel, lightLevel.has_value());
+        frame.LightLevel = lightLevel.value_or(0);
+        frame.Set(MovieFrame::LightLevelUp, solar->LightLevelUp());
+        frame.Set(MovieFrame::LightLevelDown, solar->LightLevelDown());
+    }
+
+    if (_cursor.IsTouching()) {
+        glm::uvec2 touch = _cursor.ConsoleTouchPosition();
+        frame.Set(MovieFrame::Touching, true);
+        frame.TouchX = touch.x;
+        frame.TouchY = touch.y;
+    } else {
+        frame.Set(MovieFrame::TouchReleased, _cursor.TouchReleased());
+    }
+
+    return frame;
+}
+
 void InputState::SetConfig(const CoreConfig& config) noexcept {
     ZoneScopedN(TracyFunction);
     _joypad.SetConfig(config);
@@ -25,6 +25,7 @@
 #include "config/types.hpp"
 #include "cursor.hpp"
 #include "joypad.hpp"
+#include "movie.hpp"
 #include "pointer.hpp"
 #include "retro/task_queue.hpp"
 #include "rumble.hpp"
@@ -63,6 +64,15 @@ namespace MelonDsDs {
         void Update(const ScreenLayoutData& layout) noexcept;
         void SetSlot2Input(const melonDS::GBACart::CartCommon& gbacart) noexcept;
         void Apply(melonDS::NDS& nds, ScreenLayoutData& layout, MicrophoneState& mic) const noexcept;
+
+        /// Forwards a recorded frame of input to the emulated DS instead of the frontend's input.
+        /// The frontend's input is still used for anything that doesn't affect emulation,
+        /// e.g. cycling the screen layout.
+        void Apply(melonDS::NDS& nds, ScreenLayoutData& layout, MicrophoneState& mic, const MovieFrame& frame) const noexcept;
+
+        /// Returns the input that was most recently forwarded to the emulated DS.
+        /// Must be called after Apply().
+        [[nodiscard]] MovieFrame CaptureFrame(const melonDS::NDS& nds) const noexcept;
         [[nodiscard]] bool CursorVisible() const noexcept { return _cursor.CursorVisible(); }
         [[nodiscard]] bool IsTouching() const noexcept { return _cursor.IsTouching(); }
         [[nodiscard]] bool TouchReleased() const noexcept {
@@ -53,6 +53,8 @@ namespace MelonDsDs {
             return _lightLevelDownCombo && !_previousLightLevelDownCombo;
         }
 
+        /// The active-low key mask that Apply() sends to the emulated DS
+        [[nodiscard]] uint32_t ConsoleButtons() const noexcept { return _consoleButtons; }
         [[nodiscard]] retro_perf_tick_t LastPointerUpdate() const noexcept { return _lastPointerUpdate; }
         [[nodiscard]] bool CycleLayoutPressed() const noexcept { return _cycleLayoutButton && !_previousCycleLayoutButton; }
         [[nodiscard]] bool MicButtonDown() const noexcept { return _micButton; }
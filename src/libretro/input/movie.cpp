@@ -0,0 +1,253 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "movie.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+#include <compat/strl.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+
+#include "environment.hpp"
+#include "retro/info.hpp"
+#include "tracy.hpp"
+
+using std::optional;
+using std::nullopt;
+using std::string;
+
+constexpr const char* const MOVIE_EXTENSION = ".mdsmovie";
+
+// Movies are meant to be shared between machines,
+// so all multibyte fields are stored little-endian regardless of the host
+template<typename T>
+static void WriteLE(std::byte* dest, T value) noexcept {
+    using U = std::make_unsigned_t<T>;
+    U bits = static_cast<U>(value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        dest[i] = static_cast<std::byte>(bits >> (8 * i));
+    }
+}
+
+template<typename T>
+static T ReadLE(const std::byte* src) noexcept {
+    using U = std::make_unsigned_t<T>;
+    U bits = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bits |= static_cast<U>(std::to_integer<U>(src[i]) << (8 * i));
+    }
+    return static_cast<T>(bits);
+}
+
+std::array<std::byte, MelonDsDs::MovieFrame::SIZE> MelonDsDs::MovieFrame::Encode() const noexcept {
+    std::array<std::byte, SIZE> bytes {};
+    WriteLE(&bytes[0], Keys);
+    bytes[2] = static_cast<std::byte>(TouchX);
+    bytes[3] = static_cast<std::byte>(TouchY);
+    bytes[4] = static_cast<std::byte>(Flags);
+    bytes[5] = static_cast<std::byte>(LightLevel);
+    return bytes;
+}
+
+MelonDsDs::MovieFrame MelonDsDs::MovieFrame::Decode(std::span<const std::byte, SIZE> bytes) noexcept {
+    MovieFrame frame;
+    frame.Keys = ReadLE<uint16_t>(&bytes[0]);
+    frame.TouchX = std::to_integer<uint8_t>(bytes[2]);
+    frame.TouchY = std::to_integer<uint8_t>(bytes[3]);
+    frame.Flags = std::to_integer<uint8_t>(bytes[4]);
+    frame.LightLevel = std::to_integer<uint8_t>(bytes[5]);
+    return frame;
+}
+
+static std::array<std::byte, MelonDsDs::MovieHeader::SIZE> EncodeHeader(const MelonDsDs::MovieHeader& header) noexcept {
+    using MelonDsDs::MovieHeader;
+    std::array<std::byte, MovieHeader::SIZE> bytes {};
+    memcpy(&bytes[0], MovieHeader::MAGIC.data(), MovieHeader::MAGIC.size());
+    WriteLE(&bytes[4], MovieHeader::VERSION);
+    bytes[6] = static_cast<std::byte>(header.MicInputMode);
+    bytes[7] = static_cast<std::byte>(header.MicButtonMode);
+    WriteLE(&bytes[8], header.StartTime);
+    WriteLE(&bytes[16], header.StateSize);
+    // Bytes 20-23 are reserved
+    return bytes;
+}
+
+bool MelonDsDs::MovieState::StartRecording(std::string_view path, const MovieHeader& header, std::span<const std::byte> state) noexcept {
+    ZoneScopedN(TracyFunction);
+    Stop();
+
+    retro::rfile_ptr file = retro::make_rfile(path, RETRO_VFS_FILE_ACCESS_WRITE);
+    if (!file) {
+        retro::error("Failed to open \"{}\" for recording", path);
+        return false;
+    }
+
+    _header = header;
+    _header.StateSize = state.size();
+    std::array<std::byte, MovieHeader::SIZE> encodedHeader = EncodeHeader(_header);
+    if (filestream_write(file.get(), encodedHeader.data(), encodedHeader.size()) != encodedHeader.size()) {
+        retro::error("Failed to write movie header to \"{}\"", path);
+        return false;
+    }
+
+    if (!state.empty() && filestream_write(file.get(), state.data(), state.size()) != state.size()) {
+        retro::error("Failed to write {}-byte starting savestate to \"{}\"", state.size(), path);
+        return false;
+    }
+
+    _file = std::move(file);
+    _path = path;
+    _mode = MovieMode::Record;
+    _frameNumber = 0;
+    retro::info("Recording movie to \"{}\" (starting from {})", path, state.empty() ? "boot" : "a savestate");
+    return true;
+}
+
+bool MelonDsDs::MovieState::StartPlayback(std::string_view path) noexcept {
+    ZoneScopedN(TracyFunction);
+    Stop();
+
+    retro::rfile_ptr file = retro::make_rfile(path, RETRO_VFS_FILE_ACCESS_READ);
+    if (!file) {
+        retro::error("Failed to open movie \"{}\" for playback", path);
+        return false;
+    }
+
+    std::array<std::byte, MovieHeader::SIZE> bytes {};
+    if (filestream_read(file.get(), bytes.data(), bytes.size()) != bytes.size()) {
+        retro::error("Movie \"{}\" is too small to have a header", path);
+        return false;
+    }
+
+    if (memcmp(bytes.data(), MovieHeader::MAGIC.data(), MovieHeader::MAGIC.size()) != 0) {
+        retro::error("\"{}\" is not a melonDS DS movie", path);
+        return false;
+    }
+
+    if (uint16_t version = ReadLE<uint16_t>(&bytes[4]); version != MovieHeader::VERSION) {
+        retro::error("Expected movie version {}, got {}", MovieHeader::VERSION, version);
+        return false;
+    }
+
+    MovieHeader header;
+    header.MicInputMode = static_cast<MelonDsDs::MicInputMode>(std::to_integer<uint8_t>(bytes[6]));
+    header.MicButtonMode = static_cast<MelonDsDs::MicButtonMode>(std::to_integer<uint8_t>(bytes[7]));
+    header.StartTime = ReadLE<int64_t>(&bytes[8]);
+    header.StateSize = ReadLE<uint32_t>(&bytes[16]);
+
+    int64_t fileSize = filestream_get_size(file.get());
+    int64_t bodySize = fileSize - static_cast<int64_t>(MovieHeader::SIZE) - header.StateSize;
+    if (bodySize < 0) {
+        retro::error("Movie \"{}\" claims a {}-byte savestate but is only {} bytes long", path, header.StateSize, fileSize);
+        return false;
+    }
+
+    std::vector<std::byte> state(header.StateSize);
+    if (!state.empty() && filestream_read(file.get(), state.data(), state.size()) != state.size()) {
+        retro::error("Failed to read starting savestate from \"{}\"", path);
+        return false;
+    }
+
+    // A partial frame at the end means the recording was cut off; just drop it
+    std::vector<std::byte> frames(bodySize - (bodySize % MovieFrame::SIZE));
+    if (!frames.empty() && filestream_read(file.get(), frames.data(), frames.size()) != frames.size()) {
+        retro::error("Failed to read input from \"{}\"", path);
+        return false;
+    }
+
+    _header = header;
+    _state = std::move(state);
+    _frames = std::move(frames);
+    _statePending = !_state.empty();
+    _path = path;
+    _mode = MovieMode::Play;
+    _frameNumber = 0;
+    retro::info("Playing {}-frame movie \"{}\" (starting from {})", _frames.size() / MovieFrame::SIZE, path, _statePending ? "a savestate" : "boot");
+    return true;
+}
+
+void MelonDsDs::MovieState::Record(const MovieFrame& frame) noexcept {
+    ZoneScopedN(TracyFunction);
+    if (_mode != MovieMode::Record || !_file) [[unlikely]]
+        return;
+
+    std::array<std::byte, MovieFrame::SIZE> bytes = frame.Encode();
+    if (filestream_write(_file.get(), bytes.data(), bytes.size()) != bytes.size()) [[unlikely]] {
+        retro::error("Failed to write frame {} to \"{}\"; stopping the recording", _frameNumber, _path);
+        retro::set_error_message("Movie recording failed. See the log for details.");
+        Stop();
+        return;
+    }
+
+    ++_frameNumber;
+}
+
+optional<MelonDsDs::MovieFrame> MelonDsDs::MovieState::NextFrame() noexcept {
+    if (_mode != MovieMode::Play) [[likely]]
+        return nullopt;
+
+    size_t offset = _frameNumber * MovieFrame::SIZE;
+    if (offset + MovieFrame::SIZE > _frames.size()) {
+        // If we've run out of input...
+        retro::info("Finished playing movie \"{}\" after {} frames", _path, _frameNumber);
+        Stop();
+        return nullopt;
+    }
+
+    ++_frameNumber;
+    return MovieFrame::Decode(std::span<const std::byte, MovieFrame::SIZE>(&_frames[offset], MovieFrame::SIZE));
+}
+
+std::span<const std::byte> MelonDsDs::MovieState::TakeStartState() noexcept {
+    if (!_statePending)
+        return {};
+
+    _statePending = false;
+    return _state;
+}
+
+void MelonDsDs::MovieState::Stop() noexcept {
+    if (_mode == MovieMode::Record) {
+        retro::info("Stopped recording movie \"{}\" after {} frames", _path, _frameNumber);
+    }
+
+    _file = nullptr; // Flushes and closes the recording, if any
+    _frames.clear();
+    _frames.shrink_to_fit();
+    _state.clear();
+    _state.shrink_to_fit();
+    _statePending = false;
+    _mode = MovieMode::Disabled;
+}
+
+optional<string> MelonDsDs::GetMovieHostPath(const retro::GameInfo* ndsInfo) noexcept {
+    char movieName[PATH_MAX] {}; // "game.mdsmovie"
+    if (ndsInfo) {
+        // If we're playing a game...
+        const char* ptr = path_basename(ndsInfo->GetPath().data()); // "game.nds"
+        strlcpy(movieName, ptr ? ptr : ndsInfo->GetPath().data(), sizeof(movieName));
+        path_remove_extension(movieName); // "game"
+    }
+    else {
+        // If we're booting to the firmware menu...
+        strlcpy(movieName, "firmware", sizeof(movieName));
+    }
+    strlcat(movieName, MOVIE_EXTENSION, sizeof(movieName));
+
+    return retro::get_save_subdir_path(movieName);
+}
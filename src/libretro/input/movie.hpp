@@ -0,0 +1,129 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "config/types.hpp"
+#include "retro/file.hpp"
+#include "std/span.hpp"
+
+namespace retro {
+    class GameInfo;
+}
+
+namespace MelonDsDs {
+    /// One frame of input as the emulated console sees it,
+    /// i.e. after the frontend's input has been mapped by the screen layout and the core options.
+    /// Recording this instead of the frontend's raw input keeps movies valid
+    /// even if the player changes their screen layout or touch mode.
+    struct MovieFrame {
+        enum Flag : uint8_t {
+            Touching = 1 << 0,
+            TouchReleased = 1 << 1,
+            LidClosed = 1 << 2,
+            MicButton = 1 << 3,
+            HasLightLevel = 1 << 4,
+            LightLevelUp = 1 << 5,
+            LightLevelDown = 1 << 6,
+        };
+
+        static constexpr size_t SIZE = 6;
+
+        /// Active-low key mask, as given to NDS::SetKeyMask
+        uint16_t Keys = 0xFFF;
+        uint8_t TouchX = 0;
+        uint8_t TouchY = 0;
+        uint8_t Flags = 0;
+        uint8_t LightLevel = 0;
+
+        [[nodiscard]] bool Has(Flag flag) const noexcept { return Flags & flag; }
+        void Set(Flag flag, bool value) noexcept {
+            Flags = static_cast<uint8_t>(value ? (Flags | flag) : (Flags & ~flag));
+        }
+
+        [[nodiscard]] std::array<std::byte, SIZE> Encode() const noexcept;
+        [[nodiscard]] static MovieFrame Decode(std::span<const std::byte, SIZE> bytes) noexcept;
+    };
+
+    struct MovieHeader {
+        static constexpr std::array<char, 4> MAGIC = {'M', 'D', 'S', 'M'};
+        static constexpr uint16_t VERSION = 1;
+        static constexpr size_t SIZE = 24;
+
+        MelonDsDs::MicInputMode MicInputMode = MelonDsDs::MicInputMode::None;
+        MelonDsDs::MicButtonMode MicButtonMode = MelonDsDs::MicButtonMode::Hold;
+        /// The time that the emulated RTC starts at, in seconds since the epoch (local time).
+        /// Ignored if the movie starts from a savestate, since the RTC is part of it.
+        int64_t StartTime = 0;
+        /// Size of the savestate that the movie starts from, or 0 if it starts from boot.
+        /// The savestate itself immediately follows the header.
+        uint32_t StateSize = 0;
+    };
+
+    /// Records the emulated console's per-frame input to a file,
+    /// or plays it back so that every run of a game sees exactly the same input.
+    /// Together with a fixed RTC, this makes frame hashes and frame times
+    /// comparable across builds.
+    class MovieState {
+    public:
+        [[nodiscard]] MovieMode Mode() const noexcept { return _mode; }
+        [[nodiscard]] bool IsActive() const noexcept { return _mode != MovieMode::Disabled; }
+        [[nodiscard]] bool IsRecording() const noexcept { return _mode == MovieMode::Record; }
+        [[nodiscard]] bool IsPlaying() const noexcept { return _mode == MovieMode::Play; }
+        [[nodiscard]] const MovieHeader& Header() const noexcept { return _header; }
+        [[nodiscard]] size_t FrameNumber() const noexcept { return _frameNumber; }
+
+        /// Starts a new movie at the given path, overwriting any that's already there.
+        /// @param state The savestate that the movie starts from, or an empty span to start from boot.
+        bool StartRecording(std::string_view path, const MovieHeader& header, std::span<const std::byte> state) noexcept;
+
+        /// Loads the movie at the given path into memory and starts playing it from the first frame.
+        bool StartPlayback(std::string_view path) noexcept;
+
+        [[gnu::hot]] void Record(const MovieFrame& frame) noexcept;
+
+        /// Returns the next frame of input if a movie is playing.
+        /// Stops playback and returns \c nullopt once the movie runs out of frames.
+        [[gnu::hot]] std::optional<MovieFrame> NextFrame() noexcept;
+
+        /// Returns the savestate that playback should start from (if any) exactly once,
+        /// so that the core can load it before the first frame.
+        [[nodiscard]] std::span<const std::byte> TakeStartState() noexcept;
+
+        void Stop() noexcept;
+    private:
+        MovieMode _mode = MovieMode::Disabled;
+        MovieHeader _header {};
+        std::string _path;
+        retro::rfile_ptr _file = nullptr;
+        std::vector<std::byte> _frames {};
+        std::vector<std::byte> _state {};
+        size_t _frameNumber = 0;
+        bool _statePending = false;
+    };
+
+    /// Returns the path of the movie file for the given game,
+    /// which is kept in the core's save directory.
+    std::optional<std::string> GetMovieHostPath(const retro::GameInfo* ndsInfo) noexcept;
+}
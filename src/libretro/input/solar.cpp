@@ -134,6 +134,10 @@ void SolarSensorState::SetConfig(const CoreConfig& config) noexcept {
 }
 
 void SolarSensorState::Apply(melonDS::NDS& nds) const noexcept {
+    Apply(nds, LightLevel(), _buttonUp, _buttonDown);
+}
+
+void SolarSensorState::Apply(melonDS::NDS& nds, std::optional<uint8_t> lightLevel, bool buttonUp, bool buttonDown) noexcept {
     auto* gbacart = nds.GetGBACart();
     if (!gbacart || gbacart->Type() != melonDS::GBACart::CartType::GameSolarSensor)
         // If a photosensor-enabled GBA game isn't inserted...
@@ -141,20 +145,26 @@ void SolarSensorState::Apply(melonDS::NDS& nds) const noexcept {
 
     auto* solarcart = static_cast<melonDS::GBACart::CartGameSolarSensor*>(gbacart);
 
-    if (_lux) {
+    if (lightLevel) {
         // If we could read the illuminance sensor...
-        // Taken from the mgba core's use of the light sensor
-        // (I don't actually know how this math works)
-        uint8_t lightLevel = static_cast<uint8_t>(cbrtf(*_lux) * 8);
-        TracyPlot("Solar Sensor Light Level", static_cast<int64_t>(lightLevel));
-        solarcart->SetLightLevel(lightLevel);
+        TracyPlot("Solar Sensor Light Level", static_cast<int64_t>(*lightLevel));
+        solarcart->SetLightLevel(*lightLevel);
     }
     else {
-        if (_buttonUp) {
+        if (buttonUp) {
             solarcart->SetInput(melonDS::GBACart::Input_SolarSensorUp, true);
         }
-        if (_buttonDown) {
+        if (buttonDown) {
             solarcart->SetInput(melonDS::GBACart::Input_SolarSensorDown, true);
         }
     }
+}
+
+std::optional<uint8_t> SolarSensorState::LightLevel() const noexcept {
+    if (!_lux)
+        return std::nullopt;
+
+    // Taken from the mgba core's use of the light sensor
+    // (I don't actually know how this math works)
+    return static_cast<uint8_t>(cbrtf(*_lux) * 8);
 }
\ No newline at end of file
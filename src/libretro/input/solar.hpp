@@ -42,7 +42,13 @@ namespace MelonDsDs {
         void SetConfig(const CoreConfig& config) noexcept;
         void Apply(melonDS::NDS& nds) const noexcept;
 
+        // Forwards an explicit light level (or light level button presses) to the solar sensor, if one is inserted
+        static void Apply(melonDS::NDS& nds, std::optional<uint8_t> lightLevel, bool buttonUp, bool buttonDown) noexcept;
+
         [[nodiscard]] std::optional<float> LuxReading() const noexcept { return _lux; }
+        [[nodiscard]] std::optional<uint8_t> LightLevel() const noexcept;
+        [[nodiscard]] bool LightLevelUp() const noexcept { return _buttonUp; }
+        [[nodiscard]] bool LightLevelDown() const noexcept { return _buttonDown; }
     private:
         enum class InterfaceState : uint8_t {
             Off,
@@ -16,13 +16,25 @@
 
 #define SKIP_STDIO_REDEFINES
 
+#include "file.hpp"
+
+#include <algorithm>
+#include <array>
 #include <cerrno>
+#include <cstring>
 #include <memory>
 #include <system_error>
 #include <unordered_map>
+#include <unordered_set>
 #include <unistd.h>
 #include <vector>
 
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include <file/file_path.h>
 #include <Platform.h>
 #include <streams/file_stream.h>
@@ -43,6 +55,21 @@ using namespace melonDS::Platform;
 using std::unique_ptr;
 using std::unordered_map;
 
+// The DSi NAND and SD card images are read and written a few 512-byte sectors at a time,
+// so reading ahead and coalescing writes saves a lot of VFS calls
+constexpr size_t SECTOR_SIZE = 512;
+constexpr size_t DISK_IMAGE_BUFFER_SIZE = 64 * 1024;
+
+// Disk images that are only read (such as read-only SD cards) don't need as much read-ahead
+constexpr size_t READ_ONLY_BUFFER_SIZE = 4 * 1024;
+
+static MelonDsDs::FileStats _fileStats {};
+static std::unordered_set<Platform::FileHandle*> _openFiles {};
+
+// Set by whoever knows what a file is for (see SetFileAccessHints),
+// since melonDS opens some files (e.g. SD card images) itself
+static std::unordered_map<std::string, unsigned> _fileAccessHints {};
+
 constexpr unsigned GetRetroVfsFileAccessFlags(FileMode mode, bool file_exists) noexcept {
     unsigned retro_mode = 0;
     if (mode & FileMode::Read)
@@ -57,17 +84,18 @@ constexpr unsigned GetRetroVfsFileAccessFlags(FileMode mode, bool file_exists) n
     return retro_mode;
 }
 
-unsigned GetRetroVfsFileAccessHints(const std::string& path) noexcept {
-    // TODO: If this path matches an SD card path, NAND path, or firmware path,
-    // then we should return RETRO_VFS_FILE_ACCESS_HINT_FREQUENT_ACCESS
+static unsigned GetRetroVfsFileAccessHints(const std::string& path) noexcept {
+    auto hints = _fileAccessHints.find(path);
+    return hints != _fileAccessHints.end() ? hints->second : RETRO_VFS_FILE_ACCESS_HINT_NONE;
+}
 
-    if (string_ends_with(path.c_str(), ".bin")) {
-        // TODO: When I submit that PR with those new Platform calls,
-        // use them instead of relying on a .bin file extension
-        return RETRO_VFS_FILE_ACCESS_HINT_FREQUENT_ACCESS;
+constexpr size_t GetFileBufferSize(FileMode mode, unsigned hints) noexcept {
+    if ((mode & FileMode::Text) || !(hints & RETRO_VFS_FILE_ACCESS_HINT_FREQUENT_ACCESS)) {
+        // Text files are read a line at a time by the VFS, and rarely-used files aren't worth it
+        return 0;
     }
 
-    return RETRO_VFS_FILE_ACCESS_HINT_NONE;
+    return (mode & FileMode::Write) ? DISK_IMAGE_BUFFER_SIZE : READ_ONLY_BUFFER_SIZE;
 }
 
 constexpr unsigned GetRetroVfsFileSeekOrigin(FileSeekOrigin origin) noexcept {
@@ -86,8 +114,451 @@ constexpr unsigned GetRetroVfsFileSeekOrigin(FileSeekOrigin origin) noexcept {
 struct melonDS::Platform::FileHandle {
     RFILE *file;
     unsigned hints;
+
+    /// Holds the file's contents at [bufferOffset, bufferOffset + bufferLength),
+    /// or is empty if this file isn't buffered.
+    std::vector<uint8_t> buffer;
+    int64_t bufferOffset = 0;
+    size_t bufferLength = 0;
+
+    /// The part of the buffer that hasn't been written to the file yet,
+    /// or nothing if dirtyEnd <= dirtyStart.
+    size_t dirtyStart = 0;
+    size_t dirtyEnd = 0;
+
+    /// The whole file, if it's a local disk image that could be memory-mapped.
+    /// Mapped files don't use the buffer.
+    uint8_t* mapping = nullptr;
+    size_t mappingSize = 0;
+    int fd = -1;
+
+    /// Where the next read or write goes, if this file is buffered or mapped.
+    /// (The RFILE's own position is wherever the last VFS call left it.)
+    int64_t position = 0;
+
+    /// If set, the file itself is opened read-only
+    /// and writes go to the overlay instead (see OpenCopyOnWriteFile).
+    bool copyOnWrite = false;
+
+    /// Sectors that have been written to a copy-on-write file, keyed by sector number.
+    /// They never reach the file itself, and are discarded when it's closed.
+    std::unordered_map<int64_t, std::array<uint8_t, SECTOR_SIZE>> overlay;
+
+    /// The file's size as seen through the overlay.
+    int64_t overlayLength = 0;
+
+    [[nodiscard]] bool IsBuffered() const noexcept { return !buffer.empty() || mapping; }
+    [[nodiscard]] bool IsMapped() const noexcept { return mapping != nullptr; }
+    [[nodiscard]] bool IsDirty() const noexcept { return dirtyEnd > dirtyStart; }
 };
 
+static bool IsZero(const uint8_t* data, size_t length) noexcept {
+    // Compares the data against itself shifted by one byte, which is faster than a loop
+    return length == 0 || (data[0] == 0 && memcmp(data, data + 1, length - 1) == 0);
+}
+
+// A freshly-created SD card image is mostly zeroes, so writing those zeroes out would waste time and disk space.
+// If a write of all zeroes starts at or past the file's end, this grows the file instead of writing anything,
+// which leaves a hole in the file (on file systems that support sparse files).
+static bool ExtendWithZeroes(Platform::FileHandle& file, int64_t offset, const uint8_t* data, int64_t length) noexcept {
+    if (length <= 0 || !IsZero(data, length))
+        return false;
+
+    int64_t size = filestream_get_size(file.file);
+    if (size < 0 || offset < size)
+        return false;
+
+    if (filestream_truncate(file.file, offset + length) != 0)
+        return false;
+
+    _fileStats.SkippedZeroBytes += length;
+    return true;
+}
+
+#ifdef HAVE_MMAP
+// Maps the file's first size bytes, replacing any existing mapping
+static bool MapFile(Platform::FileHandle& file, size_t size) noexcept {
+    ZoneScopedN(TracyFunction);
+    int protection = file.copyOnWrite ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* mapping = mmap(nullptr, size, protection, MAP_SHARED, file.fd, 0);
+    if (mapping == MAP_FAILED) {
+        retro::warn("Failed to map {} bytes of \"{}\": {}", size, filestream_get_path(file.file), strerror(errno));
+        return false;
+    }
+
+    // The NAND and SD card images are FAT file systems, so access is all over the place
+    posix_madvise(mapping, size, POSIX_MADV_RANDOM);
+
+    if (file.mapping) {
+        munmap(file.mapping, file.mappingSize);
+    }
+    file.mapping = static_cast<uint8_t*>(mapping);
+    file.mappingSize = size;
+    return true;
+}
+
+// Memory-maps a disk image if it's a regular local file, since not every VFS path is
+static bool OpenMappedFile(Platform::FileHandle& file, const char* path) noexcept {
+    ZoneScopedN(TracyFunction);
+    file.fd = open(path, (file.copyOnWrite ? O_RDONLY : O_RDWR) | O_CLOEXEC);
+    if (file.fd < 0)
+        return false;
+
+    struct stat st {};
+    if (fstat(file.fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || !MapFile(file, st.st_size)) {
+        close(file.fd);
+        file.fd = -1;
+        return false;
+    }
+
+    _fileStats.MappedFiles++;
+    return true;
+}
+
+// Writes back the mapping's dirty pages.
+// Flushes only schedule the writeback so that they don't stall the frame;
+// closing the file waits for it to finish.
+static bool SyncMappedFile(Platform::FileHandle& file, bool wait) noexcept {
+    ZoneScopedN(TracyFunction);
+    if (file.copyOnWrite) // Nothing is ever written to the mapping
+        return true;
+
+    if (msync(file.mapping, file.mappingSize, wait ? MS_SYNC : MS_ASYNC) != 0) {
+        retro::error("Failed to write back \"{}\": {}", filestream_get_path(file.file), strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+// Stops using the mapping, and buffers the file through the VFS instead
+static bool UnmapFile(Platform::FileHandle& file) noexcept {
+    ZoneScopedN(TracyFunction);
+    bool ok = SyncMappedFile(file, true);
+    munmap(file.mapping, file.mappingSize);
+    close(file.fd);
+    file.mapping = nullptr;
+    file.mappingSize = 0;
+    file.fd = -1;
+    file.buffer.resize(DISK_IMAGE_BUFFER_SIZE);
+    file.bufferOffset = 0;
+    file.bufferLength = 0;
+    return ok;
+}
+#else
+static bool OpenMappedFile(Platform::FileHandle&, const char*) noexcept { return false; }
+static bool SyncMappedFile(Platform::FileHandle&, bool) noexcept { return true; }
+static bool UnmapFile(Platform::FileHandle&) noexcept { return true; }
+#endif
+
+// Writes the buffer's dirty bytes to the file
+static bool FlushBuffer(Platform::FileHandle& file) noexcept {
+    if (file.IsMapped())
+        return SyncMappedFile(file, false);
+
+    if (!file.IsDirty())
+        return true;
+
+    ZoneScopedN(TracyFunction);
+    int64_t length = file.dirtyEnd - file.dirtyStart;
+    int64_t offset = file.bufferOffset + file.dirtyStart;
+    bool ok = ExtendWithZeroes(file, offset, file.buffer.data() + file.dirtyStart, length);
+    if (!ok) {
+        ok = filestream_seek(file.file, offset, RETRO_VFS_SEEK_POSITION_START) == 0;
+        if (ok) {
+            ok = filestream_write(file.file, file.buffer.data() + file.dirtyStart, length) == length;
+            _fileStats.VfsWrites++;
+        }
+    }
+
+    if (!ok) {
+        retro::error("Failed to write {} buffered bytes to \"{}\"", length, filestream_get_path(file.file));
+    }
+
+    file.dirtyStart = 0;
+    file.dirtyEnd = 0;
+    return ok;
+}
+
+// Flushes the buffer, then forgets its contents (e.g. because the file is about to change behind its back)
+static bool InvalidateBuffer(Platform::FileHandle& file) noexcept {
+    bool ok = FlushBuffer(file);
+    file.bufferOffset = 0;
+    file.bufferLength = 0;
+    return ok;
+}
+
+// Flushes the buffer, then fills it with the file's contents starting at the sector that holds the given position
+static void FillBuffer(Platform::FileHandle& file, int64_t position) noexcept {
+    ZoneScopedN(TracyFunction);
+    FlushBuffer(file);
+
+    file.bufferOffset = position - (position % SECTOR_SIZE);
+    file.bufferLength = 0;
+    if (filestream_seek(file.file, file.bufferOffset, RETRO_VFS_SEEK_POSITION_START) == 0) {
+        int64_t bytesRead = filestream_read(file.file, file.buffer.data(), file.buffer.size());
+        file.bufferLength = std::max<int64_t>(bytesRead, 0);
+        _fileStats.VfsReads++;
+    }
+}
+
+// Hands a buffered file back to the VFS for an operation that doesn't go through the buffer
+static void SyncBufferedFile(Platform::FileHandle& file) noexcept {
+    if (file.IsMapped()) {
+        // The VFS might change the file's size behind the mapping's back
+        UnmapFile(file);
+    }
+
+    InvalidateBuffer(file);
+    filestream_seek(file.file, file.position, RETRO_VFS_SEEK_POSITION_START);
+}
+
+static int64_t ReadMapped(Platform::FileHandle& file, uint8_t* data, uint64_t length) noexcept {
+    if (file.position >= int64_t(file.mappingSize))
+        return 0;
+
+    size_t bytesRead = std::min<uint64_t>(length, file.mappingSize - file.position);
+    memcpy(data, file.mapping + file.position, bytesRead);
+    file.position += bytesRead;
+    return bytesRead;
+}
+
+static int64_t WriteBuffered(Platform::FileHandle& file, const uint8_t* data, uint64_t length) noexcept;
+
+static int64_t WriteMapped(Platform::FileHandle& file, const uint8_t* data, uint64_t length) noexcept {
+    if (length == 0)
+        return 0;
+
+    size_t start = file.position;
+    size_t end = start + length;
+    size_t oldSize = file.mappingSize;
+#ifdef HAVE_MMAP
+    if (end > file.mappingSize) {
+        // If this write would make the file bigger...
+        if (ftruncate(file.fd, end) != 0 || !MapFile(file, end)) {
+            // ...and we can't grow the mapping with it, then go through the VFS from now on.
+            UnmapFile(file);
+            return WriteBuffered(file, data, length);
+        }
+    }
+#endif
+
+    if (start < oldSize) {
+        memcpy(file.mapping + start, data, std::min(end, oldSize) - start);
+    }
+
+    // Whatever's past the old end of the file is already zero (and not yet allocated, if the file is sparse),
+    // so only copy the sectors that actually have something in them
+    for (size_t sector = std::max(start, oldSize); sector < end;) {
+        size_t sectorEnd = std::min(end, sector - (sector % SECTOR_SIZE) + SECTOR_SIZE);
+        const uint8_t* sectorData = data + (sector - start);
+        if (IsZero(sectorData, sectorEnd - sector)) {
+            _fileStats.SkippedZeroBytes += sectorEnd - sector;
+        } else {
+            memcpy(file.mapping + sector, sectorData, sectorEnd - sector);
+        }
+        sector = sectorEnd;
+    }
+
+    file.position = end;
+    return length;
+}
+
+static int64_t ReadBuffered(Platform::FileHandle& file, uint8_t* data, uint64_t length) noexcept {
+    if (file.IsMapped())
+        return ReadMapped(file, data, length);
+
+    if (length >= file.buffer.size()) {
+        // If this read is too big to benefit from the buffer (e.g. loading a whole BIOS image)...
+        FlushBuffer(file); // ...make sure the file has everything we've written, then read it directly.
+        if (filestream_seek(file.file, file.position, RETRO_VFS_SEEK_POSITION_START) != 0)
+            return -1;
+
+        int64_t bytesRead = filestream_read(file.file, data, length);
+        _fileStats.VfsReads++;
+        if (bytesRead > 0) {
+            file.position += bytesRead;
+        }
+        return bytesRead;
+    }
+
+    uint64_t total = 0;
+    while (total < length) {
+        if (file.position < file.bufferOffset || file.position >= file.bufferOffset + int64_t(file.bufferLength)) {
+            // If the next byte isn't in the buffer...
+            FillBuffer(file, file.position);
+            if (file.position >= file.bufferOffset + int64_t(file.bufferLength)) {
+                // If we're at the end of the file...
+                break;
+            }
+        }
+
+        size_t offset = file.position - file.bufferOffset;
+        size_t chunk = std::min<uint64_t>(length - total, file.bufferLength - offset);
+        memcpy(data + total, file.buffer.data() + offset, chunk);
+        total += chunk;
+        file.position += chunk;
+    }
+
+    return total;
+}
+
+static int64_t WriteBuffered(Platform::FileHandle& file, const uint8_t* data, uint64_t length) noexcept {
+    if (file.IsMapped())
+        return WriteMapped(file, data, length);
+
+    if (length >= file.buffer.size()) {
+        // If this write is too big to benefit from the buffer...
+        InvalidateBuffer(file); // ...then write it directly, since it might overlap the buffer.
+        if (ExtendWithZeroes(file, file.position, data, length)) {
+            file.position += length;
+            return length;
+        }
+
+        if (filestream_seek(file.file, file.position, RETRO_VFS_SEEK_POSITION_START) != 0)
+            return -1;
+
+        int64_t bytesWritten = filestream_write(file.file, data, length);
+        _fileStats.VfsWrites++;
+        if (bytesWritten > 0) {
+            file.position += bytesWritten;
+        }
+        return bytesWritten;
+    }
+
+    uint64_t total = 0;
+    while (total < length) {
+        int64_t validEnd = file.bufferOffset + int64_t(file.bufferLength);
+        int64_t windowEnd = file.bufferOffset + int64_t(file.buffer.size());
+        if (file.position < file.bufferOffset || file.position > validEnd || file.position >= windowEnd) {
+            // If the next byte can't be written into the buffer without leaving a hole in it...
+            FillBuffer(file, file.position);
+            if (file.position > file.bufferOffset + int64_t(file.bufferLength)) {
+                // If we're writing past the end of the file, let the VFS fill in the gap
+                if (ExtendWithZeroes(file, file.position, data + total, length - total)) {
+                    file.position += length - total;
+                    total = length;
+                    break;
+                }
+
+                if (filestream_seek(file.file, file.position, RETRO_VFS_SEEK_POSITION_START) != 0)
+                    break;
+
+                int64_t bytesWritten = filestream_write(file.file, data + total, length - total);
+                _fileStats.VfsWrites++;
+                if (bytesWritten > 0) {
+                    total += bytesWritten;
+                    file.position += bytesWritten;
+                }
+                break;
+            }
+        }
+
+        size_t offset = file.position - file.bufferOffset;
+        size_t chunk = std::min<uint64_t>(length - total, file.buffer.size() - offset);
+        memcpy(file.buffer.data() + offset, data + total, chunk);
+        if (file.IsDirty()) {
+            // Any clean bytes between the old and new dirty ranges match the file, so rewriting them is harmless
+            file.dirtyStart = std::min(file.dirtyStart, offset);
+            file.dirtyEnd = std::max(file.dirtyEnd, offset + chunk);
+        }
+        else {
+            file.dirtyStart = offset;
+            file.dirtyEnd = offset + chunk;
+        }
+        file.bufferLength = std::max(file.bufferLength, offset + chunk);
+        total += chunk;
+        file.position += chunk;
+    }
+
+    return total;
+}
+
+// Reads from the overlay where it has the sector in question, and from the file everywhere else
+static int64_t ReadCopyOnWrite(Platform::FileHandle& file, uint8_t* data, uint64_t length) noexcept {
+    if (file.position >= file.overlayLength)
+        return 0;
+
+    length = std::min<uint64_t>(length, file.overlayLength - file.position);
+    uint64_t total = 0;
+    while (total < length) {
+        int64_t sector = file.position / SECTOR_SIZE;
+        size_t offset = file.position % SECTOR_SIZE;
+        uint64_t chunk = std::min<uint64_t>(length - total, SECTOR_SIZE - offset);
+        if (auto it = file.overlay.find(sector); it != file.overlay.end()) {
+            memcpy(data + total, it->second.data() + offset, chunk);
+            file.position += chunk;
+        }
+        else {
+            // Read every consecutive sector that isn't in the overlay at once
+            while (total + chunk < length && !file.overlay.count((file.position + chunk) / SECTOR_SIZE)) {
+                chunk = std::min<uint64_t>(length - total, chunk + SECTOR_SIZE);
+            }
+
+            int64_t start = file.position;
+            int64_t bytesRead = std::max<int64_t>(ReadBuffered(file, data + total, chunk), 0);
+            if (uint64_t(bytesRead) < chunk) {
+                // If the overlay made the file bigger, then the part past the file's real end is zeroes
+                memset(data + total + bytesRead, 0, chunk - bytesRead);
+            }
+            file.position = start + chunk;
+        }
+
+        total += chunk;
+    }
+
+    return total;
+}
+
+// Copies each sector that's written to into the overlay (if it isn't already there),
+// then writes to that copy
+static int64_t WriteCopyOnWrite(Platform::FileHandle& file, const uint8_t* data, uint64_t length) noexcept {
+    uint64_t total = 0;
+    while (total < length) {
+        int64_t sector = file.position / SECTOR_SIZE;
+        size_t offset = file.position % SECTOR_SIZE;
+        uint64_t chunk = std::min<uint64_t>(length - total, SECTOR_SIZE - offset);
+        auto it = file.overlay.find(sector);
+        if (it == file.overlay.end()) {
+            std::array<uint8_t, SECTOR_SIZE> original {};
+            if (chunk < SECTOR_SIZE) {
+                // If this write only covers part of the sector, the rest has to come from the file
+                int64_t start = file.position;
+                file.position = sector * SECTOR_SIZE;
+                ReadCopyOnWrite(file, original.data(), SECTOR_SIZE);
+                file.position = start;
+            }
+
+            it = file.overlay.emplace(sector, original).first;
+            _fileStats.OverlaySectors++;
+        }
+
+        memcpy(it->second.data() + offset, data + total, chunk);
+        total += chunk;
+        file.position += chunk;
+    }
+
+    file.overlayLength = std::max(file.overlayLength, file.position);
+    return total;
+}
+
+static int64_t GetFileLength(Platform::FileHandle& file) noexcept {
+    if (file.copyOnWrite)
+        return file.overlayLength;
+
+    if (file.IsMapped())
+        return file.mappingSize;
+
+    int64_t size = filestream_get_size(file.file);
+    if (file.bufferLength > 0) {
+        // Buffered writes past the end of the file haven't made it grow yet
+        // (but an empty buffer that was filled from past the end says nothing about the file's size)
+        size = std::max(size, file.bufferOffset + int64_t(file.bufferLength));
+    }
+
+    return size;
+}
+
 Platform::FileHandle *Platform::OpenFile(const std::string& path, FileMode mode) {
     ZoneScopedN(TracyFunction);
     if ((mode & FileMode::ReadWrite) == FileMode::None)
@@ -114,7 +585,50 @@ Platform::FileHandle *Platform::OpenFile(const std::string& path, FileMode mode)
         return nullptr;
     }
 
-    retro::debug("Opened \"{}\" in FileMode {}", path, mode);
+    size_t bufferSize = GetFileBufferSize(mode, handle->hints);
+    _openFiles.insert(handle);
+    if (bufferSize == DISK_IMAGE_BUFFER_SIZE && file_exists && OpenMappedFile(*handle, path.c_str())) {
+        // If this is a disk image that we could map into memory...
+        retro::debug("Opened \"{}\" in FileMode {} (memory-mapped)", path, mode);
+    }
+    else {
+        handle->buffer.resize(bufferSize);
+        retro::debug("Opened \"{}\" in FileMode {} (with a {}-byte buffer)", path, mode, handle->buffer.size());
+    }
+
+    return handle;
+}
+
+void MelonDsDs::SetFileAccessHints(const std::string& path, unsigned hints) noexcept {
+    if (hints == RETRO_VFS_FILE_ACCESS_HINT_NONE) {
+        _fileAccessHints.erase(path);
+    }
+    else {
+        _fileAccessHints[path] = hints;
+    }
+}
+
+Platform::FileHandle* MelonDsDs::OpenCopyOnWriteFile(const std::string& path) noexcept {
+    ZoneScopedN(TracyFunction);
+    Platform::FileHandle *handle = new Platform::FileHandle;
+    handle->hints = RETRO_VFS_FILE_ACCESS_HINT_FREQUENT_ACCESS;
+    handle->file = filestream_open(path.c_str(), RETRO_VFS_FILE_ACCESS_READ, handle->hints);
+    if (!handle->file) {
+        retro::error("Failed to open \"{}\" for copy-on-write access", path);
+        delete handle;
+        return nullptr;
+    }
+
+    handle->copyOnWrite = true;
+    handle->overlayLength = filestream_get_size(handle->file);
+    _openFiles.insert(handle);
+    if (OpenMappedFile(*handle, path.c_str())) {
+        retro::debug("Opened \"{}\" for copy-on-write access (memory-mapped)", path);
+    }
+    else {
+        handle->buffer.resize(DISK_IMAGE_BUFFER_SIZE);
+        retro::debug("Opened \"{}\" for copy-on-write access (with a {}-byte buffer)", path, handle->buffer.size());
+    }
 
     return handle;
 }
@@ -187,7 +701,12 @@ bool Platform::CloseFile(FileHandle* file)
     char path[PATH_MAX];
     strlcpy(path, filestream_get_path(file->file), sizeof(path));
     retro::debug("Closing \"{}\"", path);
-    bool ok = (filestream_close(file->file) == 0);
+    if (file->copyOnWrite) {
+        retro::debug("Discarding {} changed sectors of \"{}\"", file->overlay.size(), path);
+    }
+    _openFiles.erase(file);
+    bool ok = file->IsMapped() ? UnmapFile(*file) : FlushBuffer(*file);
+    ok = (filestream_close(file->file) == 0) && ok;
 
     if (!ok) {
         retro::error("Failed to close \"{}\"", path);
@@ -204,6 +723,9 @@ bool Platform::IsEndOfFile(FileHandle* file)
     if (!file)
         return false;
 
+    if (file->IsBuffered())
+        return file->position >= GetFileLength(*file);
+
     return filestream_eof(file->file) == EOF;
 }
 
@@ -213,6 +735,19 @@ bool Platform::FileReadLine(char* str, int count, FileHandle* file)
     if (!file || !str)
         return false;
 
+    if (file->copyOnWrite) {
+        // Copy-on-write files are disk images, not text
+        retro::error("Can't read lines from copy-on-write file \"{}\"", filestream_get_path(file->file));
+        return false;
+    }
+
+    if (file->IsBuffered()) {
+        SyncBufferedFile(*file);
+        bool ok = filestream_gets(file->file, str, count);
+        file->position = filestream_tell(file->file);
+        return ok;
+    }
+
     return filestream_gets(file->file, str, count);
 }
 
@@ -222,14 +757,42 @@ bool Platform::FileSeek(FileHandle* file, s64 offset, FileSeekOrigin origin)
     if (!file)
         return false;
 
+    if (file->IsBuffered()) {
+        // Seeking a buffered file doesn't touch the VFS at all
+        int64_t base = 0;
+        switch (origin) {
+            case FileSeekOrigin::Current:
+                base = file->position;
+                break;
+            case FileSeekOrigin::End:
+                base = GetFileLength(*file);
+                break;
+            default:
+                break;
+        }
+
+        if (base + offset < 0)
+            return false;
+
+        file->position = base + offset;
+        return true;
+    }
+
     return filestream_seek(file->file, offset, GetRetroVfsFileSeekOrigin(origin)) == 0;
 }
 
 void Platform::FileRewind(FileHandle* file)
 {
     ZoneScopedN(TracyFunction);
-    if (file)
+    if (!file)
+        return;
+
+    if (file->IsBuffered()) {
+        file->position = 0;
+    }
+    else {
         filestream_rewind(file->file);
+    }
 }
 
 u64 Platform::FileRead(void* data, u64 size, u64 count, FileHandle* file)
@@ -238,7 +801,19 @@ u64 Platform::FileRead(void* data, u64 size, u64 count, FileHandle* file)
     if (!file || !data)
         return 0;
 
-    int64_t bytesRead = filestream_read(file->file, data, size * count);
+    int64_t bytesRead;
+    _fileStats.Reads++;
+    if (file->copyOnWrite) {
+        bytesRead = ReadCopyOnWrite(*file, static_cast<uint8_t*>(data), size * count);
+    }
+    else if (file->IsBuffered()) {
+        bytesRead = ReadBuffered(*file, static_cast<uint8_t*>(data), size * count);
+    }
+    else {
+        bytesRead = filestream_read(file->file, data, size * count);
+        _fileStats.VfsReads++;
+    }
+
     if (bytesRead < 0) {
         retro::error("Failed to read from file \"{}\"", filestream_get_path(file->file));
     } else if (bytesRead != size * count) {
@@ -254,7 +829,8 @@ bool Platform::FileFlush(FileHandle* file)
     if (!file)
         return false;
 
-    return filestream_flush(file->file) == 0;
+    bool ok = FlushBuffer(*file);
+    return (filestream_flush(file->file) == 0) && ok;
 }
 
 u64 Platform::FileWrite(const void* data, u64 size, u64 count, FileHandle* file)
@@ -263,7 +839,23 @@ u64 Platform::FileWrite(const void* data, u64 size, u64 count, FileHandle* file)
     if (!file || !data)
         return 0;
 
-    u64 bytesWritten = filestream_write(file->file, data, size * count);
+    int64_t bytesWritten;
+    _fileStats.Writes++;
+    if (file->copyOnWrite) {
+        bytesWritten = WriteCopyOnWrite(*file, static_cast<const uint8_t*>(data), size * count);
+    }
+    else if (file->IsBuffered()) {
+        bytesWritten = WriteBuffered(*file, static_cast<const uint8_t*>(data), size * count);
+    }
+    else {
+        bytesWritten = filestream_write(file->file, data, size * count);
+        _fileStats.VfsWrites++;
+    }
+
+    if (bytesWritten < 0) {
+        retro::error("Failed to write to file \"{}\"", filestream_get_path(file->file));
+        return 0;
+    }
 
     return bytesWritten / size;
 }
@@ -274,10 +866,23 @@ u64 Platform::FileWriteFormatted(FileHandle* file, const char* fmt, ...)
     if (!file || !fmt)
         return 0;
 
+    if (file->copyOnWrite) {
+        retro::error("Can't write formatted text to copy-on-write file \"{}\"", filestream_get_path(file->file));
+        return 0;
+    }
+
+    if (file->IsBuffered()) {
+        SyncBufferedFile(*file);
+    }
+
     va_list args;
     va_start(args, fmt);
     u64 ret = filestream_vprintf(file->file, fmt, args);
     va_end(args);
+
+    if (file->IsBuffered()) {
+        file->position = filestream_tell(file->file);
+    }
     return ret;
 }
 
@@ -287,9 +892,23 @@ u64 Platform::FileLength(FileHandle* file)
     if (!file)
         return 0;
 
-    int64_t size = filestream_get_size(file->file);
+    int64_t size = GetFileLength(*file);
     if (filestream_error(file->file)) {
         retro::error("Failed to get size of file \"{}\"", filestream_get_path(file->file));
     }
     return size;
-}
\ No newline at end of file
+}
+
+bool MelonDsDs::FlushOpenFiles() noexcept {
+    ZoneScopedN(TracyFunction);
+    bool ok = true;
+    for (Platform::FileHandle* file : _openFiles) {
+        ok = FlushBuffer(*file) && ok;
+    }
+
+    return ok;
+}
+
+const MelonDsDs::FileStats& MelonDsDs::GetFileStats() noexcept {
+    return _fileStats;
+}
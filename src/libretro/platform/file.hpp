@@ -0,0 +1,63 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MELONDSDS_PLATFORM_FILE_HPP
+#define MELONDSDS_PLATFORM_FILE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace melonDS::Platform {
+    struct FileHandle;
+}
+
+namespace MelonDsDs {
+    /// Counts of file operations that melonDS asked for,
+    /// and of the VFS calls that were actually made to serve them.
+    /// Operations on memory-mapped files don't need VFS calls at all.
+    struct FileStats {
+        uint64_t Reads = 0;
+        uint64_t Writes = 0;
+        uint64_t VfsReads = 0;
+        uint64_t VfsWrites = 0;
+        /// Files that were memory-mapped instead of going through the VFS
+        uint64_t MappedFiles = 0;
+        /// Sectors copied into the overlay of a copy-on-write file
+        uint64_t OverlaySectors = 0;
+        /// Zeroes that didn't need to be written because they were past the end of the file
+        uint64_t SkippedZeroBytes = 0;
+    };
+
+    /// Tells OpenFile how the file at the given path will be used
+    /// (as RETRO_VFS_FILE_ACCESS_HINT flags), which decides how it's buffered and whether it's memory-mapped.
+    /// Needed for files that melonDS opens by itself, such as SD card images.
+    /// Files without hints are opened with RETRO_VFS_FILE_ACCESS_HINT_NONE.
+    void SetFileAccessHints(const std::string& path, unsigned hints) noexcept;
+
+    /// Opens a disk image so that it can be read and written without ever being changed.
+    /// The image itself is opened read-only (so other instances can share it),
+    /// and changed sectors are kept in memory until the file is closed, at which point they're discarded.
+    /// Close the file with melonDS::Platform::CloseFile.
+    melonDS::Platform::FileHandle* OpenCopyOnWriteFile(const std::string& path) noexcept;
+
+    /// Writes out any buffered data for every file that melonDS has open,
+    /// so that what's on disk matches what the emulated console sees (e.g. before saving a state).
+    bool FlushOpenFiles() noexcept;
+
+    const FileStats& GetFileStats() noexcept;
+}
+
+#endif // MELONDSDS_PLATFORM_FILE_HPP
@@ -14,31 +14,325 @@
     with melonDS DS. If not, see http://www.gnu.org/licenses/.
 */
 
+#include "thread.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <utility>
+
 #include <libretro.h>
+#include <compat/strl.h>
 #include <rthreads/rthreads.h>
 #include <Platform.h>
+#include <fmt/format.h>
 
-#include <utility>
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include "environment.hpp"
+#include "tracy.hpp"
 
 using namespace melonDS;
+using MelonDsDs::ThreadAffinity;
+using MelonDsDs::ThreadPriority;
+using MelonDsDs::ThreadRole;
 using Platform::Thread;
 struct Platform::Thread {
     sthread_t *thread;
 };
 struct ThreadData {
+    std::string name;
+    ThreadRole role;
     std::function<void()> fn;
 };
 
+namespace {
+    std::atomic<ThreadAffinity> _affinity {ThreadAffinity::Default};
+    std::atomic<ThreadPriority> _priority {ThreadPriority::Default};
+
+#if defined(__linux__)
+    // Linux nice values; lower means more CPU time
+    constexpr int HIGH_PRIORITY_NICE = -5;
+    constexpr int LOW_PRIORITY_NICE = 5;
+
+    struct CoreSets {
+        // Every core that isn't one of the slowest (i.e. the big and prime cores on a big.LITTLE system)
+        cpu_set_t Fast;
+        // The slowest cores (i.e. the little cores)
+        cpu_set_t Slow;
+    };
+
+    struct SavedThreadState {
+        cpu_set_t Affinity;
+        int Nice;
+    };
+#elif defined(__APPLE__)
+    struct SavedThreadState {
+        qos_class_t QosClass;
+        int RelativePriority;
+    };
+#elif defined(_WIN32)
+    struct SavedThreadState {
+        int Priority;
+    };
+#else
+    struct SavedThreadState {};
+#endif
+
+    // The emulation thread belongs to the frontend, so we put it back the way we found it
+    std::optional<SavedThreadState> _emulationThreadState;
+}
+
+#if defined(__linux__)
+static pid_t GetThreadId() noexcept {
+    return static_cast<pid_t>(syscall(SYS_gettid));
+}
+
+// Returns the given core's maximum frequency in kHz, or 0 if it's unknown
+static unsigned long GetMaxCoreFrequency(int cpu) noexcept {
+    char path[64] {};
+    fmt::format_to_n(path, sizeof(path) - 1, "/sys/devices/system/cpu/cpu{}/cpufreq/cpuinfo_max_freq", cpu);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return 0;
+
+    char buffer[32] {};
+    ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    return length > 0 ? strtoul(buffer, nullptr, 10) : 0;
+}
+
+// Splits the host's cores by speed, or returns nullopt if they're all the same
+static const std::optional<CoreSets>& GetCoreSets() noexcept {
+    static const std::optional<CoreSets> coreSets = []() -> std::optional<CoreSets> {
+        ZoneScopedN(TracyFunction);
+        long cpuCount = std::min<long>(sysconf(_SC_NPROCESSORS_CONF), CPU_SETSIZE);
+        unsigned long slowest = 0;
+        unsigned long fastest = 0;
+        std::array<unsigned long, CPU_SETSIZE> frequencies {};
+        for (int cpu = 0; cpu < cpuCount; ++cpu) {
+            frequencies[cpu] = GetMaxCoreFrequency(cpu);
+            if (frequencies[cpu] == 0)
+                continue;
+
+            slowest = slowest == 0 ? frequencies[cpu] : std::min(slowest, frequencies[cpu]);
+            fastest = std::max(fastest, frequencies[cpu]);
+        }
+
+        if (fastest == 0 || slowest == fastest) {
+            // If we couldn't read the frequencies, or if every core runs at the same speed...
+            retro::debug("All CPU cores are the same speed (or their speeds are unknown); thread affinity won't be changed");
+            return std::nullopt;
+        }
+
+        CoreSets sets {};
+        CPU_ZERO(&sets.Fast);
+        CPU_ZERO(&sets.Slow);
+        for (int cpu = 0; cpu < cpuCount; ++cpu) {
+            if (frequencies[cpu] == slowest) {
+                CPU_SET(cpu, &sets.Slow);
+            }
+            else if (frequencies[cpu] != 0) {
+                CPU_SET(cpu, &sets.Fast);
+            }
+        }
+
+        retro::info("Found {} performance and {} efficiency CPU cores", CPU_COUNT(&sets.Fast), CPU_COUNT(&sets.Slow));
+        return sets;
+    }();
+
+    return coreSets;
+}
+
+static void ApplyThreadPolicy(ThreadRole role, ThreadAffinity affinity, ThreadPriority priority) noexcept {
+    bool foreground = role != ThreadRole::Io;
+    if (affinity == ThreadAffinity::Performance) {
+        if (const std::optional<CoreSets>& sets = GetCoreSets()) {
+            const cpu_set_t& cores = foreground ? sets->Fast : sets->Slow;
+            if (sched_setaffinity(0, sizeof(cores), &cores) < 0) {
+                retro::warn("Failed to set thread affinity: {}", strerror(errno));
+            }
+        }
+    }
+
+    if (priority == ThreadPriority::High) {
+        pid_t tid = GetThreadId();
+        errno = 0;
+        int nice = getpriority(PRIO_PROCESS, tid);
+        int newNice = foreground ? std::min(nice, HIGH_PRIORITY_NICE) : std::max(nice, LOW_PRIORITY_NICE);
+        if (errno == 0 && newNice != nice && setpriority(PRIO_PROCESS, tid, newNice) < 0) {
+            // Raising priority usually needs CAP_SYS_NICE, so this isn't unusual
+            retro::debug("Failed to change thread priority from {} to {}: {}", nice, newNice, strerror(errno));
+        }
+    }
+}
+
+static SavedThreadState SaveThreadState() noexcept {
+    SavedThreadState state {};
+    CPU_ZERO(&state.Affinity);
+    if (sched_getaffinity(0, sizeof(state.Affinity), &state.Affinity) < 0) {
+        // If we couldn't get the original affinity, we'll restore it to all cores
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET(cpu, &state.Affinity);
+        }
+    }
+    state.Nice = getpriority(PRIO_PROCESS, GetThreadId());
+    return state;
+}
+
+static void RestoreThreadState(const SavedThreadState& state) noexcept {
+    sched_setaffinity(0, sizeof(state.Affinity), &state.Affinity);
+    setpriority(PRIO_PROCESS, GetThreadId(), state.Nice);
+}
+
+static void SetCurrentThreadName(const char* name) noexcept {
+    char truncated[16] {}; // Linux thread names can't be longer than 15 bytes
+    strlcpy(truncated, name, sizeof(truncated));
+    pthread_setname_np(pthread_self(), truncated);
+}
+#elif defined(__APPLE__)
+// On Apple platforms, the QoS class decides both the priority and which cores a thread may use
+static void ApplyThreadPolicy(ThreadRole role, ThreadAffinity affinity, ThreadPriority priority) noexcept {
+    if (affinity == ThreadAffinity::Default && priority == ThreadPriority::Default)
+        return;
+
+    qos_class_t qos = role == ThreadRole::Io ? QOS_CLASS_UTILITY : QOS_CLASS_USER_INTERACTIVE;
+    if (int error = pthread_set_qos_class_self_np(qos, 0); error != 0) {
+        retro::warn("Failed to set thread QoS class: {}", strerror(error));
+    }
+}
+
+static SavedThreadState SaveThreadState() noexcept {
+    SavedThreadState state {QOS_CLASS_UNSPECIFIED, 0};
+    pthread_get_qos_class_np(pthread_self(), &state.QosClass, &state.RelativePriority);
+    return state;
+}
+
+static void RestoreThreadState(const SavedThreadState& state) noexcept {
+    if (state.QosClass != QOS_CLASS_UNSPECIFIED) {
+        pthread_set_qos_class_self_np(state.QosClass, state.RelativePriority);
+    }
+}
+
+static void SetCurrentThreadName(const char* name) noexcept {
+    pthread_setname_np(name);
+}
+#elif defined(_WIN32)
+static void ApplyThreadPolicy(ThreadRole role, ThreadAffinity affinity, ThreadPriority priority) noexcept {
+    // Windows' scheduler already keeps foreground threads on performance cores,
+    // so only the priority is adjusted here
+    if (priority == ThreadPriority::High) {
+        int newPriority = role == ThreadRole::Io ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_ABOVE_NORMAL;
+        if (!SetThreadPriority(GetCurrentThread(), newPriority)) {
+            retro::warn("Failed to set thread priority (error {})", GetLastError());
+        }
+    }
+}
+
+static SavedThreadState SaveThreadState() noexcept {
+    return { GetThreadPriority(GetCurrentThread()) };
+}
+
+static void RestoreThreadState(const SavedThreadState& state) noexcept {
+    if (state.Priority != THREAD_PRIORITY_ERROR_RETURN) {
+        SetThreadPriority(GetCurrentThread(), state.Priority);
+    }
+}
+
+static void SetCurrentThreadName(const char* name) noexcept {
+    // SetThreadDescription was added in Windows 10 1607, so it has to be looked up at runtime
+    using SetThreadDescriptionFn = HRESULT (WINAPI*)(HANDLE, PCWSTR);
+    static const auto setThreadDescription = reinterpret_cast<SetThreadDescriptionFn>(
+        reinterpret_cast<void*>(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription"))
+    );
+
+    wchar_t wideName[64] {};
+    if (setThreadDescription && MultiByteToWideChar(CP_UTF8, 0, name, -1, wideName, std::size(wideName)) > 0) {
+        setThreadDescription(GetCurrentThread(), wideName);
+    }
+}
+#else
+static void ApplyThreadPolicy(ThreadRole, ThreadAffinity, ThreadPriority) noexcept {}
+static SavedThreadState SaveThreadState() noexcept { return {}; }
+static void RestoreThreadState(const SavedThreadState&) noexcept {}
+static void SetCurrentThreadName(const char*) noexcept {}
+#endif
+
 static void function_trampoline(void *param) {
     auto *data = (ThreadData *) param;
+    SetCurrentThreadName(data->name.c_str());
+#ifdef HAVE_TRACY
+    tracy::SetThreadName(data->name.c_str());
+#endif
+    ApplyThreadPolicy(data->role, _affinity, _priority);
     data->fn();
     delete data;
 }
 
+void MelonDsDs::SetThreadPolicy(ThreadAffinity affinity, ThreadPriority priority) noexcept {
+    _affinity = affinity;
+    _priority = priority;
+}
+
+void MelonDsDs::ApplyEmulationThreadPolicy() noexcept {
+    ZoneScopedN(TracyFunction);
+
+    // Start from the frontend's settings so that switching an option back to Default undoes it
+    ResetEmulationThreadPolicy();
+    ThreadAffinity affinity = _affinity;
+    ThreadPriority priority = _priority;
+    if (affinity == ThreadAffinity::Default && priority == ThreadPriority::Default)
+        return;
+
+    _emulationThreadState = SaveThreadState();
+    ApplyThreadPolicy(ThreadRole::Emulation, affinity, priority);
+}
+
+void MelonDsDs::ResetEmulationThreadPolicy() noexcept {
+    if (_emulationThreadState) {
+        RestoreThreadState(*_emulationThreadState);
+        _emulationThreadState = std::nullopt;
+    }
+}
+
+sthread_t* MelonDsDs::CreateThread(const char* name, ThreadRole role, std::function<void()> fn) noexcept {
+#ifdef HAVE_THREADS
+    auto* data = new ThreadData {name, role, std::move(fn)};
+    sthread_t* thread = sthread_create(function_trampoline, data);
+    if (!thread) {
+        retro::error("Failed to start thread \"{}\"", name);
+        delete data;
+    }
+
+    return thread;
+#else
+    return nullptr;
+#endif
+}
+
 Thread *Platform::Thread_Create(std::function<void()> func) {
-#if HAVE_THREADS
+#ifdef HAVE_THREADS
+    // melonDS only uses threads for its software rasterizer
     return new Thread {
-        sthread_create(function_trampoline, new ThreadData{std::move(func)})
+        MelonDsDs::CreateThread("melonDS render", ThreadRole::Render, std::move(func))
     };
 #else
     return nullptr;
@@ -46,14 +340,14 @@ Thread *Platform::Thread_Create(std::function<void()> func) {
 }
 
 void Platform::Thread_Wait(Thread *thread) {
-#if HAVE_THREADS
+#ifdef HAVE_THREADS
     sthread_join(thread->thread);
     thread->thread = nullptr;
 #endif
 }
 
 void Platform::Thread_Free(Thread *thread) {
-#if HAVE_THREADS
+#ifdef HAVE_THREADS
     if (thread->thread) {
         sthread_join(thread->thread);
         thread->thread = nullptr;
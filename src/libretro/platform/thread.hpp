@@ -0,0 +1,55 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MELONDSDS_PLATFORM_THREAD_HPP
+#define MELONDSDS_PLATFORM_THREAD_HPP
+
+#include <functional>
+
+#include <rthreads/rthreads.h>
+
+#include "config/types.hpp"
+
+namespace MelonDsDs {
+    /// What a thread is for, which decides how the thread policy treats it.
+    enum class ThreadRole {
+        /// The frontend's thread that calls retro_run and runs the emulated CPUs
+        Emulation,
+        /// melonDS's software rasterizer thread
+        Render,
+        /// Background work that nothing waits on, like writing captured frames
+        Io,
+    };
+
+    /// Sets the affinity and priority that new threads will get.
+    void SetThreadPolicy(ThreadAffinity affinity, ThreadPriority priority) noexcept;
+
+    /// Applies the current thread policy to the calling thread,
+    /// which is assumed to be the emulation thread.
+    /// Its original settings are saved the first time this changes them.
+    void ApplyEmulationThreadPolicy() noexcept;
+
+    /// Puts the emulation thread's affinity and priority back the way the frontend had them.
+    void ResetEmulationThreadPolicy() noexcept;
+
+    /// Starts a thread with the given name (as seen in top, perf, debuggers, and Tracy)
+    /// and applies the current thread policy to it.
+    /// Names longer than 15 characters may be truncated on some platforms.
+    /// @returns The new thread, or \c nullptr if it couldn't be started.
+    sthread_t* CreateThread(const char* name, ThreadRole role, std::function<void()> fn) noexcept;
+}
+
+#endif // MELONDSDS_PLATFORM_THREAD_HPP
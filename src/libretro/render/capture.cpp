@@ -0,0 +1,321 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "capture.hpp"
+
+#include <cstring>
+
+#include <compat/strl.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+#include <fmt/format.h>
+
+#include "environment.hpp"
+#include "platform/thread.hpp"
+#include "retro/info.hpp"
+#include "tracy.hpp"
+
+using std::optional;
+using std::string;
+
+constexpr const char* const FRAMES_EXTENSION = ".frames";
+constexpr const char* const RAW_VIDEO_EXTENSION = ".raw";
+constexpr double NDS_FRAME_RATE = 59.8261;
+
+namespace {
+    // Does nothing if the capture was started without a writer thread
+    class CaptureLock {
+    public:
+        explicit CaptureLock(slock_t* lock) noexcept : _lock(lock) {
+#ifdef HAVE_THREADS
+            if (_lock) slock_lock(_lock);
+#endif
+        }
+
+        ~CaptureLock() noexcept {
+#ifdef HAVE_THREADS
+            if (_lock) slock_unlock(_lock);
+#endif
+        }
+
+        CaptureLock(const CaptureLock&) = delete;
+        CaptureLock& operator=(const CaptureLock&) = delete;
+    private:
+        slock_t* _lock;
+    };
+}
+
+MelonDsDs::FrameCaptureState::~FrameCaptureState() noexcept {
+    Stop();
+}
+
+bool MelonDsDs::FrameCaptureState::Start(CaptureMode mode, std::string_view path) noexcept {
+    ZoneScopedN(TracyFunction);
+    Stop();
+
+    if (mode == CaptureMode::Disabled)
+        return true;
+
+    string pathString(path);
+    if (mode == CaptureMode::Frames) {
+        if (!path_mkdir(pathString.c_str())) {
+            retro::error("Failed to create frame capture directory \"{}\"", path);
+            return false;
+        }
+    }
+    else {
+        _rawFile = retro::make_rfile(path, RETRO_VFS_FILE_ACCESS_WRITE);
+        if (!_rawFile) {
+            retro::error("Failed to open \"{}\" for frame capture", path);
+            return false;
+        }
+    }
+
+    _free.clear();
+    for (CapturedFrame& frame : _pool) {
+        _free.push_back(&frame);
+    }
+    _queue.clear();
+    _rawSize = std::nullopt;
+    _stopping = false;
+    _frameNumber = 0;
+    _framesWritten = 0;
+    _framesDropped = 0;
+    _mode = mode;
+    _path = std::move(pathString);
+
+#ifdef HAVE_THREADS
+    _lock = slock_new();
+    _queueChanged = scond_new();
+    if (_lock && _queueChanged) {
+        _thread = CreateThread("melonDS capture", ThreadRole::Io, [this] { WriterThread(this); });
+    }
+
+    if (!_thread) {
+        // If we couldn't start the writer thread...
+        retro::warn("Failed to start the frame capture thread; frames will be written on the main thread instead");
+        if (_queueChanged) scond_free(_queueChanged);
+        if (_lock) slock_free(_lock);
+        _queueChanged = nullptr;
+        _lock = nullptr;
+    }
+#endif
+
+    retro::info("Capturing frames to \"{}\"", _path);
+    return true;
+}
+
+void MelonDsDs::FrameCaptureState::Stop() noexcept {
+    if (_mode == CaptureMode::Disabled)
+        return;
+
+    ZoneScopedN(TracyFunction);
+#ifdef HAVE_THREADS
+    if (_thread) {
+        // If the writer thread is running, let it drain the queue before it exits
+        {
+            CaptureLock lock(_lock);
+            _stopping = true;
+        }
+        scond_signal(_queueChanged);
+        sthread_join(_thread);
+        _thread = nullptr;
+    }
+
+    if (_queueChanged) scond_free(_queueChanged);
+    if (_lock) slock_free(_lock);
+    _queueChanged = nullptr;
+    _lock = nullptr;
+#endif
+
+    _rawFile = nullptr; // Flushes and closes the video, if any
+    retro::info("Stopped capturing frames to \"{}\" ({} written, {} dropped)", _path, _framesWritten.load(), _framesDropped.load());
+    if (_mode == CaptureMode::RawVideo && _rawSize) {
+        auto [width, height] = *_rawSize;
+        retro::info(
+            "To convert the captured video, run: ffmpeg -f rawvideo -pixel_format bgr0 -video_size {}x{} -framerate {} -i \"{}\" capture.mkv",
+            width,
+            height * 2,
+            NDS_FRAME_RATE,
+            _path
+        );
+    }
+
+    for (CapturedFrame& frame : _pool) {
+        // Recordings are big, so don't hang onto the memory after they're done
+        frame.Pixels.clear();
+        frame.Pixels.shrink_to_fit();
+    }
+    _free.clear();
+    _queue.clear();
+    _imageBuffer.clear();
+    _imageBuffer.shrink_to_fit();
+    _rawSize = std::nullopt;
+    _mode = CaptureMode::Disabled;
+}
+
+MelonDsDs::CapturedFrame* MelonDsDs::FrameCaptureState::Acquire(uint64_t number, unsigned width, unsigned height) noexcept {
+    CapturedFrame* frame = nullptr;
+    {
+        CaptureLock lock(_lock);
+        if (!_free.empty()) {
+            frame = _free.back();
+            _free.pop_back();
+        }
+    }
+
+    if (!frame) [[unlikely]] {
+        // If the writer thread hasn't caught up yet...
+        ++_framesDropped;
+        return nullptr;
+    }
+
+    frame->Number = number;
+    frame->Width = width;
+    frame->Height = height;
+    frame->Pixels.resize(size_t(width) * height * 2); // Only allocates for the first few frames
+    return frame;
+}
+
+void MelonDsDs::FrameCaptureState::Submit(CapturedFrame* frame) noexcept {
+    if (!frame) [[unlikely]]
+        return;
+
+#ifdef HAVE_THREADS
+    if (_thread) [[likely]] {
+        {
+            CaptureLock lock(_lock);
+            _queue.push_back(frame);
+        }
+        scond_signal(_queueChanged);
+        return;
+    }
+#endif
+
+    Write(*frame);
+    Release(frame);
+}
+
+void MelonDsDs::FrameCaptureState::Release(CapturedFrame* frame) noexcept {
+    CaptureLock lock(_lock);
+    _free.push_back(frame);
+}
+
+void MelonDsDs::FrameCaptureState::WriterThread(void* data) noexcept {
+#ifdef HAVE_THREADS
+    FrameCaptureState& self = *static_cast<FrameCaptureState*>(data);
+
+    while (true) {
+        CapturedFrame* frame = nullptr;
+        slock_lock(self._lock);
+        while (self._queue.empty() && !self._stopping) {
+            scond_wait(self._queueChanged, self._lock);
+        }
+
+        if (!self._queue.empty()) {
+            frame = self._queue.front();
+            self._queue.pop_front();
+        }
+        slock_unlock(self._lock);
+
+        if (!frame) {
+            // If we were asked to stop and there's nothing left to write...
+            break;
+        }
+
+        self.Write(*frame);
+        self.Release(frame);
+    }
+#endif
+}
+
+void MelonDsDs::FrameCaptureState::Write(CapturedFrame& frame) noexcept {
+    ZoneScopedN(TracyFunction);
+    bool ok = _mode == CaptureMode::Frames ? WriteImage(frame) : WriteRawVideo(frame);
+    if (ok) {
+        ++_framesWritten;
+    }
+    else {
+        ++_framesDropped;
+    }
+}
+
+// Writes the frame as a binary PPM, which is lossless and trivial to encode
+bool MelonDsDs::FrameCaptureState::WriteImage(const CapturedFrame& frame) noexcept {
+    unsigned height = frame.Height * 2;
+    fmt::memory_buffer header;
+    fmt::format_to(std::back_inserter(header), "P6\n{} {}\n255\n", frame.Width, height);
+
+    size_t pixelCount = size_t(frame.Width) * height;
+    _imageBuffer.resize(header.size() + pixelCount * 3);
+    memcpy(_imageBuffer.data(), header.data(), header.size());
+
+    uint8_t* dest = _imageBuffer.data() + header.size();
+    for (size_t i = 0; i < pixelCount; ++i) {
+        uint32_t pixel = frame.Pixels[i];
+        dest[i * 3 + 0] = (pixel >> 16) & 0xFF;
+        dest[i * 3 + 1] = (pixel >> 8) & 0xFF;
+        dest[i * 3 + 2] = pixel & 0xFF;
+    }
+
+    char name[32] {};
+    fmt::format_to_n(name, sizeof(name) - 1, "{:08}.ppm", frame.Number);
+    char path[PATH_MAX] {};
+    fill_pathname_join_special(path, _path.c_str(), name, sizeof(path));
+
+    if (!filestream_write_file(path, _imageBuffer.data(), _imageBuffer.size())) {
+        retro::error("Failed to write captured frame {} to \"{}\"", frame.Number, path);
+        return false;
+    }
+
+    return true;
+}
+
+// Appends the frame's pixels as-is; on little-endian hosts, XRGB8888 is ffmpeg's bgr0 format
+bool MelonDsDs::FrameCaptureState::WriteRawVideo(const CapturedFrame& frame) noexcept {
+    if (!_rawSize) {
+        _rawSize = std::make_pair(frame.Width, frame.Height);
+    }
+    else if (_rawSize->first != frame.Width || _rawSize->second != frame.Height) [[unlikely]] {
+        // Raw video can't change size partway through (e.g. if the scale factor changed)
+        return false;
+    }
+
+    int64_t size = frame.Pixels.size() * sizeof(uint32_t);
+    if (filestream_write(_rawFile.get(), frame.Pixels.data(), size) != size) {
+        retro::error("Failed to write captured frame {} to \"{}\"", frame.Number, _path);
+        return false;
+    }
+
+    return true;
+}
+
+optional<string> MelonDsDs::GetCaptureHostPath(const retro::GameInfo* ndsInfo, CaptureMode mode) noexcept {
+    char captureName[PATH_MAX] {}; // "game.frames" or "game.raw"
+    if (ndsInfo) {
+        // If we're playing a game...
+        const char* ptr = path_basename(ndsInfo->GetPath().data()); // "game.nds"
+        strlcpy(captureName, ptr ? ptr : ndsInfo->GetPath().data(), sizeof(captureName));
+        path_remove_extension(captureName); // "game"
+    }
+    else {
+        // If we're booting to the firmware menu...
+        strlcpy(captureName, "firmware", sizeof(captureName));
+    }
+    strlcat(captureName, mode == CaptureMode::RawVideo ? RAW_VIDEO_EXTENSION : FRAMES_EXTENSION, sizeof(captureName));
+
+    return retro::get_save_subdir_path(captureName);
+}
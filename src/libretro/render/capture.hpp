@@ -0,0 +1,130 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MELONDSDS_RENDER_CAPTURE_HPP
+#define MELONDSDS_RENDER_CAPTURE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <rthreads/rthreads.h>
+
+#include "config/types.hpp"
+#include "retro/file.hpp"
+
+namespace retro {
+    class GameInfo;
+}
+
+namespace MelonDsDs {
+    /// One frame of both emulated screens at the renderer's native resolution,
+    /// with the top screen's rows followed by the bottom screen's.
+    /// Pixels are XRGB8888, the same format as melonDS's software framebuffers.
+    struct CapturedFrame {
+        uint64_t Number = 0;
+        /// Size of one screen, in pixels
+        unsigned Width = 0;
+        unsigned Height = 0;
+        std::vector<uint32_t> Pixels {};
+
+        [[nodiscard]] uint32_t* TopScreen() noexcept { return Pixels.data(); }
+        [[nodiscard]] uint32_t* BottomScreen() noexcept { return Pixels.data() + Width * Height; }
+    };
+
+    /// Hands captured frames to a background thread that writes them to disk,
+    /// so that recording doesn't slow down the frame it was taken from.
+    /// Frames are taken from a fixed pool that's reused for the whole recording;
+    /// if the writer falls behind and the pool runs out, new frames are dropped instead of waiting.
+    class FrameCaptureState {
+    public:
+        FrameCaptureState() noexcept = default;
+        ~FrameCaptureState() noexcept;
+        FrameCaptureState(const FrameCaptureState&) = delete;
+        FrameCaptureState& operator=(const FrameCaptureState&) = delete;
+        FrameCaptureState(FrameCaptureState&&) = delete;
+        FrameCaptureState& operator=(FrameCaptureState&&) = delete;
+
+        [[nodiscard]] CaptureMode Mode() const noexcept { return _mode; }
+        [[nodiscard]] bool IsActive() const noexcept { return _mode != CaptureMode::Disabled; }
+
+        /// Starts writing frames to the given path,
+        /// which is a directory for CaptureMode::Frames or a file for CaptureMode::RawVideo.
+        bool Start(CaptureMode mode, std::string_view path) noexcept;
+
+        /// Writes out any frames that are still queued, then stops the writer thread.
+        void Stop() noexcept;
+
+        /// The number of the frame that's about to be presented.
+        [[nodiscard]] uint64_t FrameNumber() const noexcept { return _frameNumber; }
+
+        /// Called once per presented frame, whether or not it was captured.
+        void EndFrame() noexcept { ++_frameNumber; }
+
+        /// Returns an unused frame of the given size for the renderer to fill in,
+        /// or \c nullptr (counting the frame as dropped) if they're all waiting to be written.
+        [[nodiscard]] CapturedFrame* Acquire(uint64_t number, unsigned width, unsigned height) noexcept;
+
+        /// Queues a frame from Acquire to be written.
+        void Submit(CapturedFrame* frame) noexcept;
+
+        /// Counts a frame that the renderer couldn't capture in time.
+        void Drop() noexcept { ++_framesDropped; }
+
+        [[nodiscard]] uint64_t FramesWritten() const noexcept { return _framesWritten; }
+        [[nodiscard]] uint64_t FramesDropped() const noexcept { return _framesDropped; }
+    private:
+        static constexpr size_t POOL_SIZE = 8;
+        static void WriterThread(void* data) noexcept;
+        void Write(CapturedFrame& frame) noexcept;
+        bool WriteImage(const CapturedFrame& frame) noexcept;
+        bool WriteRawVideo(const CapturedFrame& frame) noexcept;
+        void Release(CapturedFrame* frame) noexcept;
+
+        CaptureMode _mode = CaptureMode::Disabled;
+        std::string _path {};
+        std::array<CapturedFrame, POOL_SIZE> _pool {};
+        // Both guarded by _lock
+        std::vector<CapturedFrame*> _free {};
+        std::deque<CapturedFrame*> _queue {};
+        slock_t* _lock = nullptr;
+        scond_t* _queueChanged = nullptr;
+        sthread_t* _thread = nullptr;
+        bool _stopping = false;
+
+        // Only touched by the writer thread while a recording is active
+        retro::rfile_ptr _rawFile = nullptr;
+        std::optional<std::pair<unsigned, unsigned>> _rawSize = std::nullopt;
+        std::vector<uint8_t> _imageBuffer {};
+
+        uint64_t _frameNumber = 0;
+        std::atomic<uint64_t> _framesWritten {0};
+        std::atomic<uint64_t> _framesDropped {0};
+    };
+
+    /// Returns the path that captured frames of the given game are written to,
+    /// which is kept in the core's save directory.
+    std::optional<std::string> GetCaptureHostPath(const retro::GameInfo* ndsInfo, CaptureMode mode) noexcept;
+}
+
+#endif // MELONDSDS_RENDER_CAPTURE_HPP
@@ -0,0 +1,180 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "glcapture.hpp"
+
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "capture.hpp"
+#include "environment.hpp"
+#include "screenlayout.hpp"
+#include "tracy.hpp"
+
+bool MelonDsDs::OpenGlFrameReader::Init(bool debug) noexcept {
+    ZoneScopedN(TracyFunction);
+    TracyGpuZone(TracyFunction);
+    if (Initialized())
+        return true;
+
+    glGenFramebuffers(1, &_fbo);
+    glGenBuffers(_pbos.size(), _pbos.data());
+    if (debug) {
+        glObjectLabel(GL_FRAMEBUFFER, _fbo, -1, "melonDS DS Frame Capture FBO");
+        for (size_t i = 0; i < _pbos.size(); ++i) {
+            fmt::basic_memory_buffer<char, 64> label;
+            fmt::format_to(std::back_inserter(label), "melonDS DS Frame Capture PBO #{}", i);
+            label.push_back('\0');
+            glObjectLabel(GL_BUFFER, _pbos[i], -1, label.data());
+        }
+    }
+
+    _fences = {};
+    _readbacks = {};
+    _next = 0;
+    retro::debug("Initialized OpenGL frame capture");
+    return _fbo != 0;
+}
+
+void MelonDsDs::OpenGlFrameReader::Destroy() noexcept {
+    ZoneScopedN(TracyFunction);
+    if (!Initialized())
+        return;
+
+    for (GLsync& fence : _fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    glDeleteBuffers(_pbos.size(), _pbos.data());
+    glDeleteFramebuffers(1, &_fbo);
+    Reset();
+}
+
+void MelonDsDs::OpenGlFrameReader::Reset() noexcept {
+    _fbo = 0;
+    _pbos = {};
+    _fences = {};
+    _readbacks = {};
+    _next = 0;
+}
+
+void MelonDsDs::OpenGlFrameReader::Capture(GLuint texture, unsigned scale, GLuint restoreFbo, FrameCaptureState& capture) noexcept {
+    ZoneScopedN(TracyFunction);
+    TracyGpuZone(TracyFunction);
+    if (!Initialized()) [[unlikely]]
+        return;
+
+    Collect(capture);
+
+    if (_fences[_next]) [[unlikely]] {
+        // If the GPU still hasn't finished the readback from FRAMES_IN_FLIGHT frames ago...
+        capture.Drop(); // ...then skip this frame rather than wait for it.
+        return;
+    }
+
+    // melonDS's output texture holds both screens with a small gap between them
+    glm::uvec2 textureSize(NDS_SCREEN_WIDTH * scale, (NDS_SCREEN_HEIGHT * 2 + 2) * scale);
+#ifndef HAVE_OPENGLES
+    // GLES 3.0 can't query texture sizes, but desktop OpenGL can
+    GLint width = 0;
+    GLint height = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    if (width > 0 && height > 0) {
+        textureSize = glm::uvec2(width, height);
+    }
+#endif
+
+    Readback& readback = _readbacks[_next];
+    size_t size = size_t(textureSize.x) * textureSize.y * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbos[_next]);
+    if (readback.Capacity < size) {
+        // Only reallocates when the scale factor goes up
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        readback.Capacity = size;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _fbo);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    // The texture's red and blue channels are swapped,
+    // so reading it as RGBA gives us the XRGB8888 layout that the capture expects.
+    // (nullptr means to read into the bound PBO, not to the CPU)
+    glReadPixels(0, 0, textureSize.x, textureSize.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, restoreFbo);
+
+    _fences[_next] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.Number = capture.FrameNumber();
+    readback.TextureSize = textureSize;
+    readback.Scale = scale;
+    _next = (_next + 1) % FRAMES_IN_FLIGHT;
+}
+
+void MelonDsDs::OpenGlFrameReader::Collect(FrameCaptureState& capture) noexcept {
+    ZoneScopedN(TracyFunction);
+
+    // Check the readbacks from oldest to newest
+    for (size_t i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+        size_t index = (_next + i) % FRAMES_IN_FLIGHT;
+        if (!_fences[index])
+            continue;
+
+        // Don't wait for the fence; if it hasn't gone off yet, none of the newer ones have either
+        if (glClientWaitSync(_fences[index], 0, 0) == GL_TIMEOUT_EXPIRED)
+            break;
+
+        glDeleteSync(_fences[index]);
+        _fences[index] = nullptr;
+
+        const Readback& readback = _readbacks[index];
+        unsigned screenWidth = NDS_SCREEN_WIDTH * readback.Scale;
+        unsigned screenHeight = NDS_SCREEN_HEIGHT * readback.Scale;
+        if (readback.TextureSize.x < screenWidth || readback.TextureSize.y < screenHeight * 2) [[unlikely]] {
+            capture.Drop();
+            continue;
+        }
+
+        CapturedFrame* frame = capture.Acquire(readback.Number, screenWidth, screenHeight);
+        if (!frame)
+            continue;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, _pbos[index]);
+        size_t size = size_t(readback.TextureSize.x) * readback.TextureSize.y * 4;
+        const auto* pixels = static_cast<const uint32_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+        if (!pixels) [[unlikely]] {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            capture.Drop();
+            continue;
+        }
+
+        // The top screen is at the start of the texture and the bottom screen is at the end,
+        // both right-side up since we read from a texture rather than the frontend's framebuffer
+        size_t rowSize = screenWidth * sizeof(uint32_t);
+        unsigned bottomStart = readback.TextureSize.y - screenHeight;
+        for (unsigned y = 0; y < screenHeight; ++y) {
+            memcpy(frame->TopScreen() + y * screenWidth, pixels + size_t(y) * readback.TextureSize.x, rowSize);
+            memcpy(frame->BottomScreen() + y * screenWidth, pixels + size_t(bottomStart + y) * readback.TextureSize.x, rowSize);
+        }
+
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        capture.Submit(frame);
+    }
+}
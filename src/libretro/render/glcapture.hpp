@@ -0,0 +1,72 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MELONDSDS_RENDER_GLCAPTURE_HPP
+#define MELONDSDS_RENDER_GLCAPTURE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/vec2.hpp>
+
+#include "PlatformOGLPrivate.h"
+
+namespace MelonDsDs {
+    class FrameCaptureState;
+
+    /// Reads melonDS's OpenGL output texture back to the CPU for frame capture.
+    /// Each frame is read into its own pixel buffer and copied out a few frames later,
+    /// once a fence says the GPU is done with it, so the CPU never waits on the GPU.
+    class OpenGlFrameReader {
+    public:
+        /// Creates the framebuffer and pixel buffers. Must be called with the OpenGL context current.
+        bool Init(bool debug) noexcept;
+
+        /// Deletes the OpenGL objects. Must be called with the OpenGL context current.
+        void Destroy() noexcept;
+
+        /// Forgets the OpenGL objects without deleting them, for when the context is already gone.
+        void Reset() noexcept;
+
+        [[nodiscard]] bool Initialized() const noexcept { return _fbo != 0; }
+
+        /// Hands any finished readbacks to the capture,
+        /// then starts reading back the given output texture (which holds both screens
+        /// and must be bound to GL_TEXTURE_2D).
+        /// @param restoreFbo The framebuffer to bind for reading afterwards.
+        void Capture(GLuint texture, unsigned scale, GLuint restoreFbo, FrameCaptureState& capture) noexcept;
+    private:
+        void Collect(FrameCaptureState& capture) noexcept;
+
+        struct Readback {
+            uint64_t Number = 0;
+            glm::uvec2 TextureSize {};
+            unsigned Scale = 1;
+            size_t Capacity = 0;
+        };
+
+        static constexpr size_t FRAMES_IN_FLIGHT = 3;
+        GLuint _fbo = 0;
+        std::array<GLuint, FRAMES_IN_FLIGHT> _pbos {};
+        std::array<GLsync, FRAMES_IN_FLIGHT> _fences {};
+        std::array<Readback, FRAMES_IN_FLIGHT> _readbacks {};
+        // The slot that the next readback goes into, which is also the oldest one in flight
+        size_t _next = 0;
+    };
+}
+
+#endif // MELONDSDS_RENDER_GLCAPTURE_HPP
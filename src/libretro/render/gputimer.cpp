@@ -0,0 +1,154 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "gputimer.hpp"
+
+#include <cstring>
+
+#include "environment.hpp"
+#include "tracy.hpp"
+
+static const char* const PASS_PLOT_NAMES[MelonDsDs::GPU_PASS_COUNT] = {
+    "GPU Time: Emulation (ms)",
+    "GPU Time: Presentation (ms)",
+};
+
+static bool TimerQueriesSupported() noexcept {
+#ifdef HAVE_OPENGLES
+    // GLES only has timer queries through EXT_disjoint_timer_query,
+    // whose entry points we don't load
+    return false;
+#else
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major > 3 || (major == 3 && minor >= 3))
+        return true; // Timer queries are core as of OpenGL 3.3
+
+    GLint numExtensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+    for (GLint i = 0; i < numExtensions; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension && strcmp(extension, "GL_ARB_timer_query") == 0)
+            return true;
+    }
+
+    return false;
+#endif
+}
+
+bool MelonDsDs::GpuTimer::Init() noexcept {
+    ZoneScopedN(TracyFunction);
+    if (_enabled)
+        return true;
+
+    if (_unsupported)
+        return false;
+
+    if (!TimerQueriesSupported()) {
+        retro::warn("OpenGL driver doesn't support timer queries; GPU timing will be unavailable");
+        _unsupported = true;
+        return false;
+    }
+
+    for (auto& queries : _queries) {
+        glGenQueries(queries.size(), queries.data());
+    }
+
+    _pending = {};
+    _results = {};
+    _activePass = std::nullopt;
+    _frame = 0;
+    _enabled = true;
+    retro::debug("Enabled GPU timing");
+    return true;
+}
+
+void MelonDsDs::GpuTimer::Destroy() noexcept {
+    ZoneScopedN(TracyFunction);
+    if (!_enabled)
+        return;
+
+    if (_activePass) {
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+
+    for (auto& queries : _queries) {
+        glDeleteQueries(queries.size(), queries.data());
+    }
+
+    Reset();
+}
+
+void MelonDsDs::GpuTimer::Reset() noexcept {
+    _queries = {};
+    _pending = {};
+    _results = {};
+    _activePass = std::nullopt;
+    _frame = 0;
+    _enabled = false;
+    _unsupported = false;
+}
+
+void MelonDsDs::GpuTimer::Begin(GpuPass pass) noexcept {
+    size_t index = static_cast<size_t>(pass);
+    if (!_enabled || _activePass || _pending[_frame][index])
+        // If timing is off, another pass is being timed,
+        // or this pass was already timed this frame (or its old result still isn't ready)...
+        return;
+
+    glBeginQuery(GL_TIME_ELAPSED, _queries[_frame][index]);
+    _activePass = pass;
+}
+
+void MelonDsDs::GpuTimer::End(GpuPass pass) noexcept {
+    if (!_enabled || _activePass != pass)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    _pending[_frame][static_cast<size_t>(pass)] = true;
+    _activePass = std::nullopt;
+}
+
+void MelonDsDs::GpuTimer::EndFrame() noexcept {
+    ZoneScopedN(TracyFunction);
+    if (!_enabled)
+        return;
+
+    _frame = (_frame + 1) % FRAMES_IN_FLIGHT;
+
+    // These queries were issued FRAMES_IN_FLIGHT frames ago, so they're probably done by now;
+    // if not, we'll skip timing those passes this frame instead of waiting
+    for (size_t i = 0; i < GPU_PASS_COUNT; ++i) {
+        if (!_pending[_frame][i])
+            continue;
+
+        GLuint query = _queries[_frame][i];
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available != GL_TRUE)
+            continue;
+
+#ifndef HAVE_OPENGLES
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+        _results[i] = elapsed;
+#endif
+        _pending[_frame][i] = false;
+        TracyPlot(PASS_PLOT_NAMES[i], static_cast<double>(_results[i]) / 1e6);
+    }
+}
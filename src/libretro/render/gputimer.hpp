@@ -0,0 +1,80 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MELONDSDS_RENDER_GPUTIMER_HPP
+#define MELONDSDS_RENDER_GPUTIMER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "PlatformOGLPrivate.h"
+
+namespace MelonDsDs {
+    enum class GpuPass : uint8_t {
+        /// Everything melonDS's OpenGL renderer submits while running a frame
+        /// (i.e. 3D rendering and compositing it with the 2D layers)
+        Emulation,
+        /// Drawing the emulated screens to the frontend's framebuffer
+        Presentation,
+    };
+
+    constexpr size_t GPU_PASS_COUNT = 2;
+
+    /// Measures how long the GPU spends on each part of a frame with GL_TIME_ELAPSED queries.
+    /// Each frame uses its own set of queries, and results are collected a few frames later
+    /// only if the GPU has already finished them, so the CPU never waits on the GPU.
+    class GpuTimer {
+    public:
+        /// Creates the query objects if the driver supports timer queries.
+        /// Must be called with the OpenGL context current.
+        bool Init() noexcept;
+
+        /// Deletes the query objects. Must be called with the OpenGL context current.
+        void Destroy() noexcept;
+
+        /// Forgets the query objects without deleting them, for when the context is already gone.
+        void Reset() noexcept;
+
+        [[nodiscard]] bool Enabled() const noexcept { return _enabled; }
+
+        /// False if Init already found that the driver can't do timer queries.
+        [[nodiscard]] bool Supported() const noexcept { return !_unsupported; }
+
+        /// Starts timing the given pass.
+        /// Passes can't overlap, and each one is only timed once per frame.
+        void Begin(GpuPass pass) noexcept;
+        void End(GpuPass pass) noexcept;
+
+        /// Collects any results that are ready and moves on to the next frame's queries.
+        void EndFrame() noexcept;
+
+        /// The most recently measured GPU time for the given pass, in nanoseconds.
+        [[nodiscard]] uint64_t Nanoseconds(GpuPass pass) const noexcept { return _results[static_cast<size_t>(pass)]; }
+    private:
+        static constexpr size_t FRAMES_IN_FLIGHT = 3;
+        std::array<std::array<GLuint, GPU_PASS_COUNT>, FRAMES_IN_FLIGHT> _queries {};
+        std::array<std::array<bool, GPU_PASS_COUNT>, FRAMES_IN_FLIGHT> _pending {};
+        std::array<uint64_t, GPU_PASS_COUNT> _results {};
+        std::optional<GpuPass> _activePass = std::nullopt;
+        size_t _frame = 0;
+        bool _enabled = false;
+        bool _unsupported = false;
+    };
+}
+
+#endif // MELONDSDS_RENDER_GPUTIMER_HPP
@@ -18,6 +18,7 @@
 #include "opengl.hpp"
 
 #include <array>
+#include <chrono>
 
 #include <GPU3D_OpenGL.h>
 #include <NDS.h>
@@ -134,6 +135,7 @@ constexpr unsigned GetVertexCount(ScreenLayout layout, MelonDsDs::HybridSideScre
 extern retro_hw_render_callback hw_render;
 
 static const char* const SHADER_PROGRAM_NAME = "melonDS DS Shader Program";
+static const char* const SCREEN_PROGRAM_CACHE_NAME = "melondsds_screen";
 
 
 std::unique_ptr<MelonDsDs::OpenGLRenderState> MelonDsDs::OpenGLRenderState::New() noexcept {
@@ -166,6 +168,12 @@ MelonDsDs::OpenGLRenderState::OpenGLRenderState() {
     hw_render.debug_context = true;
 #endif
 
+    // Ask the frontend to keep our context (and everything in it) alive
+    // when it reinitializes its video driver (e.g. when toggling fullscreen),
+    // so that we don't have to rebuild the 3D renderer and recompile its shaders.
+    // Frontends that don't support this will just destroy and reset the context as usual.
+    hw_render.cache_context = true;
+
     if (!glsm_ctl(GLSM_CTL_STATE_CONTEXT_INIT, &params)) {
         throw opengl_not_initialized_exception();
     }
@@ -182,6 +190,8 @@ MelonDsDs::OpenGLRenderState::~OpenGLRenderState() noexcept {
     if (_contextInitialized) {
         TracyGpuZone(TracyFunction);
         glsm_ctl(GLSM_CTL_STATE_BIND, nullptr);
+        _gpuTimer.Destroy();
+        _frameReader.Destroy();
         glDeleteTextures(1, &screen_framebuffer_texture);
 
         glDeleteVertexArrays(1, &vao);
@@ -208,10 +218,29 @@ MelonDsDs::OpenGLRenderState::~OpenGLRenderState() noexcept {
 void MelonDsDs::OpenGLRenderState::ContextReset(melonDS::NDS& nds, const CoreConfig& config) {
     ZoneScopedN(TracyFunction);
     retro::debug(TracyFunction);
+    _contextResetTime = std::chrono::steady_clock::now();
+    ++_stats.ContextResets;
 
     // Initialize all OpenGL function pointers
     retro::debug("Initializing OpenGL function pointers");
     glsm_ctl(GLSM_CTL_STATE_CONTEXT_RESET, nullptr);
+
+    if (_contextInitialized && nds.GetRenderer3D().Accelerated && ResourcesValid()) {
+        // If the frontend kept our context alive (and didn't tell us it was destroyed)...
+        retro::info("OpenGL context was preserved, reusing existing resources");
+        glsm_ctl(GLSM_CTL_STATE_SETUP, nullptr);
+
+        // Everything we own is still valid, but the frontend may have changed the default framebuffer's size,
+        // so we'll reupload the vertices and renderer settings on the next frame
+        _needsRefresh = true;
+        ++_stats.ContextReuses;
+        return;
+    }
+
+    // Any queries or capture buffers we had belonged to the old context
+    _gpuTimer.Reset();
+    _frameReader.Reset();
+
     TracyGpuContext; // Must be called AFTER the function pointers are bound!
 
     const char *vendor   = (const char*)glGetString(GL_VENDOR);
@@ -290,22 +319,40 @@ void MelonDsDs::OpenGLRenderState::SetUpCoreOpenGlState(const CoreConfig& config
 
     // TODO: Check gl_check_capability for GL_CAPS_VAO and GL_CAPS_FBO
 
-    bool shaderCompiled = melonDS::OpenGL::CompileVertexFragmentProgram(
-        _screenProgram,
-        embedded_melondsds_vertex_shader,
-        embedded_melondsds_fragment_shader,
-        SHADER_PROGRAM_NAME,
-        {
-            {"vPosition", 0},
-            {"vTexcoord", 1},
-        },
-        {
-            {"oColor", 0},
+    auto programStart = std::chrono::steady_clock::now();
+    _programCache.Init();
+    _screenProgram = _programCache.Load(SCREEN_PROGRAM_CACHE_NAME, embedded_melondsds_vertex_shader, embedded_melondsds_fragment_shader);
+    bool programCached = _screenProgram != 0;
+    if (!programCached) {
+        // If we don't have a usable binary for this driver...
+        bool shaderCompiled = melonDS::OpenGL::CompileVertexFragmentProgram(
+            _screenProgram,
+            embedded_melondsds_vertex_shader,
+            embedded_melondsds_fragment_shader,
+            SHADER_PROGRAM_NAME,
+            {
+                {"vPosition", 0},
+                {"vTexcoord", 1},
+            },
+            {
+                {"oColor", 0},
+            }
+        );
+
+        if (!shaderCompiled)
+            throw shader_compilation_failed_exception("Failed to compile and link melonDS DS screen shader program.");
+
+        if (_programCache.Available()) {
+            ++_stats.ShaderCacheMisses;
+            _programCache.Save(SCREEN_PROGRAM_CACHE_NAME, embedded_melondsds_vertex_shader, embedded_melondsds_fragment_shader, _screenProgram);
         }
-    );
+    }
+    else {
+        ++_stats.ShaderCacheHits;
+    }
 
-    if (!shaderCompiled)
-        throw shader_compilation_failed_exception("Failed to compile and link melonDS DS screen shader program.");
+    auto programTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - programStart);
+    retro::info("{} screen shader program in {}us", programCached ? "Loaded cached" : "Compiled", programTime.count());
 
     if (_openGlDebugAvailable) {
         // TODO: Fall back to glLabelObjectEXT if glObjectLabel isn't available
@@ -320,13 +367,15 @@ void MelonDsDs::OpenGLRenderState::SetUpCoreOpenGlState(const CoreConfig& config
     glUniform1i(uni_id, 0);
 
     memset(&GL_ShaderConfig, 0, sizeof(GL_ShaderConfig));
+    _shaderConfigDirty = true;
+    _outputTextureFilter = {};
 
     glGenBuffers(1, &ubo);
     glBindBuffer(GL_UNIFORM_BUFFER, ubo);
     if (_openGlDebugAvailable) {
         glObjectLabel(GL_BUFFER, ubo, -1, "melonDS DS Shader Config UBO");
     }
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(GL_ShaderConfig), &GL_ShaderConfig, GL_STATIC_DRAW);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(GL_ShaderConfig), &GL_ShaderConfig, GL_DYNAMIC_DRAW);
     glBindBufferBase(GL_UNIFORM_BUFFER, 16, ubo);
 
     glGenBuffers(1, &vbo);
@@ -373,6 +422,8 @@ void MelonDsDs::OpenGLRenderState::Render(
     retro_assert(nds.GetRenderer3D().Accelerated);
 
     glsm_ctl(GLSM_CTL_STATE_BIND, nullptr);
+    UpdateGpuTimer(config);
+    _gpuTimer.Begin(GpuPass::Presentation);
 
     GLuint current_fbo = glsm_get_current_framebuffer();
     // Tell OpenGL that we want to draw to (and read from) the screen framebuffer
@@ -389,25 +440,16 @@ void MelonDsDs::OpenGLRenderState::Render(
         _needsRefresh = false;
     }
 
-    if (!nds.IsLidClosed() && input.CursorVisible()) {
-        float cursorSize = config.CursorSize();
-        ivec2 touch = input.TouchPosition();
-        GL_ShaderConfig.cursorPos[0] = ((float) touch.x - cursorSize) / NDS_SCREEN_WIDTH;
-        GL_ShaderConfig.cursorPos[1] = (((float) touch.y - cursorSize) / (NDS_SCREEN_WIDTH * 1.5f)) + 0.5f;
-        GL_ShaderConfig.cursorPos[2] = ((float) touch.x + cursorSize) / NDS_SCREEN_WIDTH;
-        GL_ShaderConfig.cursorPos[3] = (((float) touch.y + cursorSize) / ((float) NDS_SCREEN_WIDTH * 1.5f)) + 0.5f;
-        GL_ShaderConfig.cursorVisible = true;
-    } else {
-        GL_ShaderConfig.cursorVisible = false;
-    }
+    UpdateCursor(nds, input, config);
 
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-    void *unibuf = glMapBuffer(GL_UNIFORM_BUFFER, GL_WRITE_ONLY);
-    if (unibuf) memcpy(unibuf, &GL_ShaderConfig, sizeof(GL_ShaderConfig));
-    glUnmapBuffer(GL_UNIFORM_BUFFER);
+    if (_shaderConfigDirty) {
+        // If the layout, cursor, or screen config changed since the last frame...
+        UploadShaderConfig();
+    }
 
     glUseProgram(_screenProgram);
 
+    // The 3D renderer changes these while drawing the frame, so we can't skip them
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_STENCIL_TEST);
     glDisable(GL_BLEND);
@@ -417,14 +459,9 @@ void MelonDsDs::OpenGLRenderState::Render(
     glActiveTexture(GL_TEXTURE0);
 
     renderer.BindOutputTexture(nds.GPU.FrontBuffer);
+    SetOutputTextureFilter(nds.GPU.FrontBuffer, config);
 
-    // Set the filtering mode for the active texture
-    // For simplicity, we'll just use the same filter for both minification and magnification
-    GLint filter = config.ScreenFilter() == ScreenFilter::Linear ? GL_LINEAR : GL_NEAREST;
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    // The VAO already knows about the vertex buffer, so there's no need to bind that too
     glBindVertexArray(vao);
     if (nds.IsLidClosed()) [[unlikely]] {
         // If the emulated lid is closed, just draw a blank
@@ -436,8 +473,13 @@ void MelonDsDs::OpenGLRenderState::Render(
         glDrawArrays(GL_TRIANGLES, 0, vertexCount);
     }
 
-    glFlush();
+    // No glFlush here; the frontend decides when (and whether) to synchronize
+    // once it has the frame, and flushing early just stalls the CPU on tiled GPUs.
 
+    _gpuTimer.End(GpuPass::Presentation);
+    _gpuTimer.EndFrame();
+    _stats.GpuEmulationNanoseconds = _gpuTimer.Nanoseconds(GpuPass::Emulation);
+    _stats.GpuPresentationNanoseconds = _gpuTimer.Nanoseconds(GpuPass::Presentation);
     glsm_ctl(GLSM_CTL_STATE_UNBIND, nullptr);
 
 #ifdef HAVE_TRACY
@@ -453,9 +495,141 @@ void MelonDsDs::OpenGLRenderState::Render(
         screenLayout.BufferHeight(),
         0
     );
+    ++_stats.FramesPresented;
+
+    if (_contextResetTime) [[unlikely]] {
+        // If this is the first frame since the context was reset...
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - *_contextResetTime);
+        _stats.ContextResetToFirstFrameMicroseconds = elapsed.count();
+        _contextResetTime = std::nullopt;
+        retro::info("Presented first frame {}us after the OpenGL context was reset", elapsed.count());
+    }
+
     TracyGpuCollect;
 }
 
+// Returns true if the objects we created in SetUpCoreOpenGlState still exist in the current context.
+// Must be called after the function pointers are initialized.
+bool MelonDsDs::OpenGLRenderState::ResourcesValid() const noexcept {
+    return glIsProgram(_screenProgram) == GL_TRUE
+        && glIsVertexArray(vao) == GL_TRUE
+        && glIsBuffer(vbo) == GL_TRUE
+        && glIsBuffer(ubo) == GL_TRUE
+        && glIsTexture(screen_framebuffer_texture) == GL_TRUE;
+}
+
+void MelonDsDs::OpenGLRenderState::RunFrame(melonDS::NDS& nds) noexcept {
+    TracyGpuZone("NDS::RunFrame");
+    _gpuTimer.Begin(GpuPass::Emulation);
+    nds.RunFrame();
+    _gpuTimer.End(GpuPass::Emulation);
+}
+
+void MelonDsDs::OpenGLRenderState::Capture(melonDS::NDS& nds, FrameCaptureState& capture) noexcept {
+    ZoneScopedN(TracyFunction);
+    if (!_contextInitialized || !nds.GetRenderer3D().Accelerated) [[unlikely]]
+        return;
+
+    glsm_ctl(GLSM_CTL_STATE_BIND, nullptr);
+    if (!_frameReader.Initialized()) {
+        // If this is the first frame we're capturing with this context...
+        _frameReader.Init(_openGlDebugAvailable);
+    }
+
+    // Read from the emulator's own output rather than the frontend's framebuffer,
+    // so that captures don't depend on the screen layout or the window size
+    melonDS::GLRenderer& renderer = static_cast<melonDS::GLRenderer&>(nds.GetRenderer3D());
+    glActiveTexture(GL_TEXTURE0);
+    renderer.BindOutputTexture(nds.GPU.FrontBuffer);
+    GLint texture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+
+    _frameReader.Capture(texture, renderer.GetScaleFactor(), glsm_get_current_framebuffer(), capture);
+    glsm_ctl(GLSM_CTL_STATE_UNBIND, nullptr);
+}
+
+void MelonDsDs::OpenGLRenderState::StopCapture() noexcept {
+    ZoneScopedN(TracyFunction);
+    if (!_contextInitialized || !_frameReader.Initialized())
+        return;
+
+    // Readbacks that are still in flight belong to the capture that just stopped,
+    // so don't let the next one collect them
+    glsm_ctl(GLSM_CTL_STATE_BIND, nullptr);
+    _frameReader.Destroy();
+    glsm_ctl(GLSM_CTL_STATE_UNBIND, nullptr);
+}
+
+// Creates or deletes the timer queries if the GPU timing option was toggled
+void MelonDsDs::OpenGLRenderState::UpdateGpuTimer(const CoreConfig& config) noexcept {
+    if (config.GpuTiming() == _gpuTimer.Enabled() || (config.GpuTiming() && !_gpuTimer.Supported())) [[likely]]
+        return;
+
+    if (config.GpuTiming()) {
+        if (!_gpuTimer.Init()) {
+            retro::set_warn_message("GPU timing isn't supported by this OpenGL driver.");
+        }
+    }
+    else {
+        _gpuTimer.Destroy();
+        _stats.GpuEmulationNanoseconds = 0;
+        _stats.GpuPresentationNanoseconds = 0;
+    }
+}
+
+// Recomputes the cursor's position in the shader config,
+// marking it dirty only if it actually moved or changed visibility
+void MelonDsDs::OpenGLRenderState::UpdateCursor(melonDS::NDS& nds, const InputState& input, const CoreConfig& config) noexcept {
+    if (!nds.IsLidClosed() && input.CursorVisible()) {
+        float cursorSize = config.CursorSize();
+        ivec2 touch = input.TouchPosition();
+        vec4 cursorPos(
+            ((float) touch.x - cursorSize) / NDS_SCREEN_WIDTH,
+            (((float) touch.y - cursorSize) / (NDS_SCREEN_WIDTH * 1.5f)) + 0.5f,
+            ((float) touch.x + cursorSize) / NDS_SCREEN_WIDTH,
+            (((float) touch.y + cursorSize) / ((float) NDS_SCREEN_WIDTH * 1.5f)) + 0.5f
+        );
+
+        if (!GL_ShaderConfig.cursorVisible || GL_ShaderConfig.cursorPos != cursorPos) {
+            GL_ShaderConfig.cursorPos = cursorPos;
+            GL_ShaderConfig.cursorVisible = true;
+            _shaderConfigDirty = true;
+        }
+    } else if (GL_ShaderConfig.cursorVisible) {
+        GL_ShaderConfig.cursorVisible = false;
+        _shaderConfigDirty = true;
+    }
+}
+
+void MelonDsDs::OpenGLRenderState::UploadShaderConfig() noexcept {
+    ZoneScopedN(TracyFunction);
+    TracyGpuZone(TracyFunction);
+
+    // Respecifying the whole buffer orphans the old storage,
+    // so the driver doesn't have to wait for the previous frame's draw to finish
+    // (which is what glMapBuffer would do)
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(GL_ShaderConfig), &GL_ShaderConfig, GL_DYNAMIC_DRAW);
+    _shaderConfigDirty = false;
+    ++_stats.UniformUploads;
+}
+
+// Applies the screen filter to the 3D renderer's output texture (which must already be bound),
+// but only if it's not already using that filter
+void MelonDsDs::OpenGLRenderState::SetOutputTextureFilter(int frontBuffer, const CoreConfig& config) noexcept {
+    retro_assert(frontBuffer >= 0 && frontBuffer < (int)_outputTextureFilter.size());
+
+    GLint filter = config.ScreenFilter() == ScreenFilter::Linear ? GL_LINEAR : GL_NEAREST;
+    if (_outputTextureFilter[frontBuffer] == filter) [[likely]]
+        return;
+
+    // For simplicity, we'll just use the same filter for both minification and magnification
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    _outputTextureFilter[frontBuffer] = filter;
+    ++_stats.TextureParameterUpdates;
+}
+
 void MelonDsDs::OpenGLRenderState::ContextDestroyed() {
     ZoneScopedN(TracyFunction);
 //    TracyGpuZone(TracyFunction);
@@ -472,6 +646,11 @@ void MelonDsDs::OpenGLRenderState::ContextDestroyed() {
     vbo = 0;
     GL_ShaderConfig = {};
     ubo = 0;
+    _shaderConfigDirty = true;
+    _outputTextureFilter = {};
+    _contextResetTime = std::nullopt;
+    _gpuTimer.Reset();
+    _frameReader.Reset();
     // TODO: Delete these objects, since the context hasn't been destroyed yet
     // (just in case it's not really destroyed afterwards)
 
@@ -493,11 +672,11 @@ void MelonDsDs::OpenGLRenderState::InitFrameState(melonDS::NDS& nds, const CoreC
     GL_ShaderConfig.uScreenSize = screenLayout.BufferSize();
     GL_ShaderConfig.u3DScale = screenLayout.Scale();
     GL_ShaderConfig.cursorPos = vec4(-1);
+    GL_ShaderConfig.cursorVisible = false;
+    _shaderConfigDirty = true;
 
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-    void *unibuf = glMapBuffer(GL_UNIFORM_BUFFER, GL_WRITE_ONLY);
-    if (unibuf) memcpy(unibuf, &GL_ShaderConfig, sizeof(GL_ShaderConfig));
-    glUnmapBuffer(GL_UNIFORM_BUFFER);
+    // SetRenderSettings may have recreated the output textures with their default filter
+    _outputTextureFilter = {};
 
     InitVertices(screenLayout);
 
@@ -19,10 +19,14 @@
 #define MELONDSDS_RENDER_OPENGL_HPP
 
 #include <array>
+#include <chrono>
 #include <memory>
 #include <optional>
 
+#include "glcapture.hpp"
+#include "gputimer.hpp"
 #include "render.hpp"
+#include "shadercache.hpp"
 
 #include "PlatformOGLPrivate.h"
 #include <glm/vec2.hpp>
@@ -47,6 +51,7 @@ namespace MelonDsDs {
         OpenGLRenderState& operator=(const OpenGLRenderState&) = delete;
         OpenGLRenderState& operator=(OpenGLRenderState&&) = delete;
         [[nodiscard]] bool Ready() const noexcept override { return _contextInitialized; }
+        void RunFrame(melonDS::NDS& nds) noexcept override;
         void Render(
             melonDS::NDS& nds,
             const InputState& input,
@@ -58,6 +63,10 @@ namespace MelonDsDs {
             _needsRefresh = true;
         }
 
+        void Capture(melonDS::NDS& nds, FrameCaptureState& capture) noexcept override;
+        void StopCapture() noexcept override;
+        [[nodiscard]] RenderStats Stats() const noexcept override { return _stats; }
+
         void ContextReset(melonDS::NDS& nds, const CoreConfig& config);
         void ContextDestroyed();
     private:
@@ -71,6 +80,14 @@ namespace MelonDsDs {
         void SetUpCoreOpenGlState(const CoreConfig& config);
         void InitFrameState(melonDS::NDS& nds, const CoreConfig& config, const ScreenLayoutData& screenLayout) noexcept;
         void InitVertices(const ScreenLayoutData& screenLayout) noexcept;
+        [[nodiscard]] bool ResourcesValid() const noexcept;
+        void UpdateCursor(melonDS::NDS& nds, const InputState& input, const CoreConfig& config) noexcept;
+        void UploadShaderConfig() noexcept;
+        void SetOutputTextureFilter(int frontBuffer, const CoreConfig& config) noexcept;
+        void UpdateGpuTimer(const CoreConfig& config) noexcept;
+        ProgramBinaryCache _programCache {};
+        GpuTimer _gpuTimer {};
+        OpenGlFrameReader _frameReader {};
         bool _openGlDebugAvailable = false;
         bool _needsRefresh = true;
         bool _contextInitialized = false;
@@ -91,6 +108,15 @@ namespace MelonDsDs {
 
         GLuint ubo = 0;
 
+        // Presentation state is only sent to the GPU when it changes,
+        // since per-frame buffer mapping and texture parameter updates
+        // stall the CPU on some mobile drivers.
+        bool _shaderConfigDirty = true;
+        // The filter last applied to each of the 3D renderer's output textures, or 0 if unknown.
+        std::array<GLint, 2> _outputTextureFilter {};
+        RenderStats _stats {};
+        std::optional<std::chrono::steady_clock::time_point> _contextResetTime = std::nullopt;
+
 #ifdef HAVE_TRACY
         std::optional<OpenGlTracyCapture> _tracyCapture;
 #endif
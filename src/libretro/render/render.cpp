@@ -32,6 +32,18 @@
 #include "render/opengl.hpp"
 #endif
 
+void MelonDsDs::RenderState::RunFrame(melonDS::NDS& nds) noexcept {
+    nds.RunFrame();
+}
+
+void MelonDsDs::RenderStateWrapper::RunFrame(melonDS::NDS& nds) noexcept {
+    if (_renderState) [[likely]] {
+        _renderState->RunFrame(nds);
+    }
+    else {
+        nds.RunFrame();
+    }
+}
 
 void MelonDsDs::RenderStateWrapper::Render(
     melonDS::NDS& nds,
@@ -17,6 +17,7 @@
 #ifndef MELONDS_DS_RENDER_HPP
 #define MELONDS_DS_RENDER_HPP
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 
@@ -30,11 +31,29 @@ namespace MelonDsDs {
     class InputState;
     class ScreenLayoutData;
     class CoreConfig;
+    class FrameCaptureState;
 
     namespace error {
         class ErrorScreen;
     }
 
+    /// Counters that let tests and benchmarks verify
+    /// that the renderer isn't doing more work per frame than necessary.
+    struct RenderStats {
+        uint64_t FramesPresented = 0;
+        uint64_t UniformUploads = 0;
+        uint64_t TextureParameterUpdates = 0;
+        uint32_t ShaderCacheHits = 0;
+        uint32_t ShaderCacheMisses = 0;
+        uint32_t ContextResets = 0;
+        /// Context resets that kept all existing OpenGL resources
+        uint32_t ContextReuses = 0;
+        uint64_t ContextResetToFirstFrameMicroseconds = 0;
+        /// Only measured if GPU timing is enabled
+        uint64_t GpuEmulationNanoseconds = 0;
+        uint64_t GpuPresentationNanoseconds = 0;
+    };
+
     class RenderState {
     public:
         virtual ~RenderState() noexcept = default;
@@ -42,13 +61,27 @@ namespace MelonDsDs {
         /// Returns true if all state necessary for rendering is ready.
         /// This includes the OpenGL context (if applicable) and the emulator's renderer.
         virtual bool Ready() const noexcept = 0;
+
+        /// Runs the emulated console for one frame,
+        /// giving the renderer a chance to measure the GPU work that the emulator does.
+        virtual void RunFrame(melonDS::NDS& nds) noexcept;
         virtual void Render(melonDS::NDS& nds, const InputState& input, const CoreConfig& config, const ScreenLayoutData& screenLayout) noexcept = 0;
         virtual void RequestRefresh() noexcept {}
+
+        /// Copies the emulated screens that were just presented (at the renderer's native resolution)
+        /// into the capture's frame pool. Must not wait for the GPU.
+        virtual void Capture(melonDS::NDS& nds, FrameCaptureState& capture) noexcept {}
+
+        /// Discards any frames that are still being captured
+        /// and frees whatever the renderer allocated to capture them.
+        virtual void StopCapture() noexcept {}
+        [[nodiscard]] virtual RenderStats Stats() const noexcept { return {}; }
     };
 
     class RenderStateWrapper {
     public:
         bool Ready() const noexcept { return _renderState && _renderState->Ready(); }
+        void RunFrame(melonDS::NDS& nds) noexcept;
         void Render(melonDS::NDS& nds, const InputState& input, const CoreConfig& config, const ScreenLayoutData& screenLayout) noexcept;
         void Render(const error::ErrorScreen& error, const CoreConfig& config, const ScreenLayoutData& screenLayout) noexcept;
         void RequestRefresh() noexcept {
@@ -57,11 +90,24 @@ namespace MelonDsDs {
             }
         }
 
+        void Capture(melonDS::NDS& nds, FrameCaptureState& capture) noexcept {
+            if (_renderState) {
+                _renderState->Capture(nds, capture);
+            }
+        }
+
+        void StopCapture() noexcept {
+            if (_renderState) {
+                _renderState->StopCapture();
+            }
+        }
+
         void Apply(const CoreConfig& config) noexcept;
         [[gnu::cold]] void UpdateRenderer(const CoreConfig& config, melonDS::NDS& nds) noexcept;
         void ContextReset(melonDS::NDS& nds, const CoreConfig& config);
         void ContextDestroyed();
         std::optional<RenderMode> GetRenderMode() const noexcept;
+        [[nodiscard]] RenderStats Stats() const noexcept { return _renderState ? _renderState->Stats() : RenderStats {}; }
     private:
         void SetRenderer(const CoreConfig& config);
         std::unique_ptr<RenderState> _renderState;
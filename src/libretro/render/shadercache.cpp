@@ -0,0 +1,222 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "shadercache.hpp"
+
+#include <array>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+
+#include "environment.hpp"
+#include "retro/file.hpp"
+#include "tracy.hpp"
+
+using std::optional;
+using std::string;
+using std::string_view;
+
+constexpr const char* const CACHE_EXTENSION = ".glprogram";
+constexpr std::array<char, 4> CACHE_MAGIC = {'M', 'D', 'S', 'P'};
+constexpr uint32_t CACHE_VERSION = 1;
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+// Program binaries are only valid for the driver that produced them,
+// so unlike movies or savestates these files are stored in native byte order
+struct CacheHeader {
+    std::array<char, 4> Magic;
+    uint32_t Version;
+    uint64_t Key;
+    uint32_t Format;
+    uint32_t Length;
+};
+
+static_assert(sizeof(CacheHeader) == 24);
+static_assert(std::is_trivially_copyable_v<CacheHeader>);
+
+// FNV-1a; we just need something that's stable across runs and compilers
+static uint64_t Hash(uint64_t hash, string_view data) noexcept {
+    for (char c : data) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= FNV_PRIME;
+    }
+
+    // Hash a NUL terminator too (XORing with 0 is a no-op),
+    // so that ("ab", "c") and ("a", "bc") give different results
+    hash *= FNV_PRIME;
+    return hash;
+}
+
+static string_view GetGlString(GLenum name) noexcept {
+    const char* value = reinterpret_cast<const char*>(glGetString(name));
+    return value ? string_view(value) : string_view();
+}
+
+static optional<string> GetCachePath(string_view name) noexcept {
+    string filename(name);
+    filename += CACHE_EXTENSION;
+    return retro::get_save_subdir_path(filename);
+}
+
+void MelonDsDs::ProgramBinaryCache::Init() noexcept {
+    ZoneScopedN(TracyFunction);
+    _available = false;
+    _driverHash = 0;
+
+    if (glGetProgramBinary == nullptr || glProgramBinary == nullptr) {
+        retro::debug("OpenGL driver doesn't expose glGetProgramBinary or glProgramBinary; shader programs won't be cached");
+        return;
+    }
+
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    if (numFormats <= 0) {
+        retro::info("OpenGL driver doesn't support any program binary formats; shader programs won't be cached");
+        return;
+    }
+
+    _driverHash = Hash(FNV_OFFSET_BASIS, GetGlString(GL_VENDOR));
+    _driverHash = Hash(_driverHash, GetGlString(GL_RENDERER));
+    _driverHash = Hash(_driverHash, GetGlString(GL_VERSION));
+    _available = true;
+    retro::debug("OpenGL driver supports {} program binary format(s); shader programs will be cached", numFormats);
+}
+
+uint64_t MelonDsDs::ProgramBinaryCache::Key(string_view vertexSource, string_view fragmentSource) const noexcept {
+    return Hash(Hash(_driverHash, vertexSource), fragmentSource);
+}
+
+GLuint MelonDsDs::ProgramBinaryCache::Load(string_view name, string_view vertexSource, string_view fragmentSource) const noexcept {
+    ZoneScopedN(TracyFunction);
+    if (!_available)
+        return 0;
+
+    optional<string> path = GetCachePath(name);
+    if (!path)
+        return 0;
+
+    if (!path_is_valid(path->c_str())) {
+        retro::debug("No cached binary for \"{}\" at \"{}\"", name, *path);
+        return 0;
+    }
+
+    retro::rfile_ptr file = retro::make_rfile(*path, RETRO_VFS_FILE_ACCESS_READ);
+    if (!file) {
+        retro::warn("Failed to open cached binary for \"{}\" at \"{}\"", name, *path);
+        return 0;
+    }
+
+    CacheHeader header {};
+    if (filestream_read(file.get(), &header, sizeof(header)) != sizeof(header)) {
+        retro::warn("Cached binary \"{}\" is too small to have a header", *path);
+        return 0;
+    }
+
+    if (header.Magic != CACHE_MAGIC || header.Version != CACHE_VERSION) {
+        retro::warn("\"{}\" is not a melonDS DS program binary, or it's from an incompatible version", *path);
+        return 0;
+    }
+
+    if (header.Key != Key(vertexSource, fragmentSource)) {
+        // If the driver or the shader source changed since the binary was saved...
+        retro::info("Cached binary for \"{}\" is out of date; recompiling it", name);
+        return 0;
+    }
+
+    int64_t fileSize = filestream_get_size(file.get());
+    if (header.Length == 0 || fileSize != static_cast<int64_t>(sizeof(header) + header.Length)) {
+        retro::warn("Cached binary \"{}\" claims to be {} bytes, but the file is {} bytes", *path, header.Length, fileSize);
+        return 0;
+    }
+
+    std::vector<std::byte> binary(header.Length);
+    if (filestream_read(file.get(), binary.data(), binary.size()) != static_cast<int64_t>(binary.size())) {
+        retro::warn("Failed to read cached binary \"{}\"", *path);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.Format, binary.data(), header.Length);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        // The driver is allowed to reject binaries for any reason, even ones it produced itself
+        retro::info("OpenGL driver rejected the cached binary for \"{}\"; recompiling it", name);
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    retro::debug("Loaded {}-byte cached binary for \"{}\" from \"{}\"", header.Length, name, *path);
+    return program;
+}
+
+bool MelonDsDs::ProgramBinaryCache::Save(string_view name, string_view vertexSource, string_view fragmentSource, GLuint program) const noexcept {
+    ZoneScopedN(TracyFunction);
+    if (!_available || program == 0)
+        return false;
+
+    optional<string> path = GetCachePath(name);
+    if (!path)
+        return false;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        retro::debug("OpenGL driver didn't provide a binary for \"{}\"", name);
+        return false;
+    }
+
+    std::vector<std::byte> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) {
+        retro::debug("OpenGL driver didn't provide a binary for \"{}\"", name);
+        return false;
+    }
+
+    CacheHeader header {
+        .Magic = CACHE_MAGIC,
+        .Version = CACHE_VERSION,
+        .Key = Key(vertexSource, fragmentSource),
+        .Format = format,
+        .Length = static_cast<uint32_t>(written),
+    };
+
+    retro::rfile_ptr file = retro::make_rfile(*path, RETRO_VFS_FILE_ACCESS_WRITE);
+    if (!file) {
+        retro::warn("Failed to open \"{}\" for writing", *path);
+        return false;
+    }
+
+    if (filestream_write(file.get(), &header, sizeof(header)) != sizeof(header) ||
+        filestream_write(file.get(), binary.data(), written) != written) {
+        retro::warn("Failed to write cached binary for \"{}\" to \"{}\"", name, *path);
+        file = nullptr;
+        filestream_delete(path->c_str()); // Don't leave a truncated binary lying around
+        return false;
+    }
+
+    retro::debug("Cached {}-byte binary for \"{}\" at \"{}\"", written, name, *path);
+    return true;
+}
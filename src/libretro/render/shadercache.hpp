@@ -0,0 +1,53 @@
+/*
+    Copyright 2024 Jesse Talavera
+
+    melonDS DS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS DS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS DS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef MELONDSDS_RENDER_SHADERCACHE_HPP
+#define MELONDSDS_RENDER_SHADERCACHE_HPP
+
+#include <cstdint>
+#include <string_view>
+
+#include "PlatformOGLPrivate.h"
+
+namespace MelonDsDs {
+    /// Stores linked shader programs on disk with ARB_get_program_binary,
+    /// so that later launches and context resets can skip compiling GLSL.
+    /// Each entry is keyed by the driver's vendor, renderer, and version strings
+    /// as well as the program's source code,
+    /// so updating either the driver or the core invalidates it.
+    class ProgramBinaryCache {
+    public:
+        /// Queries the driver's capabilities.
+        /// Must be called with the OpenGL context current.
+        void Init() noexcept;
+
+        [[nodiscard]] bool Available() const noexcept { return _available; }
+
+        /// Creates a program from the cached binary named \c name.
+        /// @returns The new program, or 0 if there's no usable binary
+        /// (in which case the caller should compile the program itself).
+        [[nodiscard]] GLuint Load(std::string_view name, std::string_view vertexSource, std::string_view fragmentSource) const noexcept;
+
+        /// Writes the given linked program's binary to the cache, replacing any existing entry.
+        bool Save(std::string_view name, std::string_view vertexSource, std::string_view fragmentSource, GLuint program) const noexcept;
+    private:
+        [[nodiscard]] uint64_t Key(std::string_view vertexSource, std::string_view fragmentSource) const noexcept;
+        uint64_t _driverHash = 0;
+        bool _available = false;
+    };
+}
+
+#endif // MELONDSDS_RENDER_SHADERCACHE_HPP
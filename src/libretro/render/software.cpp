@@ -16,11 +16,14 @@
 
 #include "software.hpp"
 
+#include <cstring>
+
 #include <retro_assert.h>
 
 #include <NDS.h>
 #include <gfx/scaler/pixconv.h>
 
+#include "capture.hpp"
 #include "config/config.hpp"
 #include "config/types.hpp"
 #include "input/input.hpp"
@@ -86,15 +89,15 @@ void MelonDsDs::SoftwareRenderState::Render(
     if (tracy::ProfilerAvailable()) {
         // If Tracy is connected...
         ZoneScopedN("MelonDsDs::render::RenderSoftware::SendFrameToTracy");
-        std::unique_ptr<uint8_t[]> frame = std::make_unique<uint8_t[]>(buffer.Width() * buffer.Height() * 4);
+        tracyFrame.resize(buffer.Width() * buffer.Height() * 4);
         {
             ZoneScopedN("conv_argb8888_abgr8888");
-            conv_argb8888_abgr8888(frame.get(), buffer[0], buffer.Width(), buffer.Height(), buffer.Stride(), buffer.Stride());
+            conv_argb8888_abgr8888(tracyFrame.data(), buffer[0], buffer.Width(), buffer.Height(), buffer.Stride(), buffer.Stride());
         }
         // libretro wants pixels in XRGB8888 format,
         // but Tracy wants them in XBGR8888 format.
 
-        FrameImage(frame.get(), buffer.Width(), buffer.Height(), 0, false);
+        FrameImage(tracyFrame.data(), buffer.Width(), buffer.Height(), 0, false);
     }
 #endif
 }
@@ -111,6 +114,20 @@ void MelonDsDs::SoftwareRenderState::Render(
     retro::video_refresh(buffer[0], buffer.Width(), buffer.Height(), buffer.Stride());
 }
 
+void MelonDsDs::SoftwareRenderState::Capture(melonDS::NDS& nds, FrameCaptureState& capture) noexcept {
+    ZoneScopedN(TracyFunction);
+
+    CapturedFrame* frame = capture.Acquire(capture.FrameNumber(), NDS_SCREEN_WIDTH, NDS_SCREEN_HEIGHT);
+    if (!frame) [[unlikely]]
+        return;
+
+    // The software renderer's framebuffers are already in the capture's pixel format,
+    // so there's nothing to convert
+    memcpy(frame->TopScreen(), nds.GPU.Framebuffer[nds.GPU.FrontBuffer][0].get(), NDS_SCREEN_AREA<size_t> * sizeof(uint32_t));
+    memcpy(frame->BottomScreen(), nds.GPU.Framebuffer[nds.GPU.FrontBuffer][1].get(), NDS_SCREEN_AREA<size_t> * sizeof(uint32_t));
+    capture.Submit(frame);
+}
+
 void MelonDsDs::SoftwareRenderState::CopyScreen(const uint32_t* src, uvec2 destTranslation, ScreenLayout layout) noexcept {
     ZoneScopedN(TracyFunction);
     // Only used for software rendering
@@ -19,6 +19,7 @@
 
 #include <optional>
 #include <span>
+#include <vector>
 
 #include <glm/mat3x3.hpp>
 #include <glm/vec2.hpp>
@@ -51,6 +52,8 @@ namespace MelonDsDs {
             const ScreenLayoutData& screenLayout
         ) noexcept;
 
+        void Capture(melonDS::NDS& nds, FrameCaptureState& capture) noexcept override;
+
         unsigned BufferWidth() const noexcept { return buffer.Width(); }
         unsigned BufferHeight() const noexcept { return buffer.Height(); }
         glm::uvec2 BufferSize() const noexcept { return buffer.Size(); }
@@ -68,6 +71,10 @@ namespace MelonDsDs {
         // Used as a staging area for the hybrid screen to be scaled
         PixelBuffer hybridBuffer;
         retro::Scaler hybridScaler;
+#ifdef HAVE_TRACY
+        // Reused for every frame sent to Tracy
+        std::vector<uint8_t> tracyFrame;
+#endif
     };
 }
 
@@ -56,9 +56,7 @@ retro::dirent_tree::dirent_iterator::dirent_iterator(dirent_tree *ptr) noexcept:
     if (m_ptr) {
         ++(*this); // Find the first file
     } else {
-        memset((void *) current.path, 0, sizeof(current.path));
-        current.size = 0;
-        current.flags = 0;
+        current.clear();
     }
 }
 
@@ -86,9 +84,7 @@ retro::dirent_tree::dirent_iterator &retro::dirent_tree::dirent_iterator::operat
         }
         if (!hasNext) {
             m_ptr = nullptr;
-            memset((void *) current.path, 0, sizeof(current.path));
-            current.flags = 0;
-            current.size = 0;
+            current.clear();
             break;
         }
 
@@ -108,22 +104,38 @@ retro::dirent_tree::dirent_iterator &retro::dirent_tree::dirent_iterator::operat
             }
         }
 
-        int flags;
+        bool isDirectory;
         {
-            ZoneScopedN("path_stat");
-            flags = path_stat(filePath);
+            // Uses the type reported by the directory listing (e.g. d_type) if there is one,
+            // and only stats the file if the type is unknown
+            ZoneScopedN("retro_dirent_is_dir");
+            isDirectory = retro_dirent_is_dir(m_ptr->dir, filePath);
         }
-        if (is_regular_file(flags)) {
+        if (!isDirectory) {
             // If we've found the next file to return to whoever's using this iterator...
+            current.clear();
             strlcpy(current.path, filePath, sizeof(current.path));
-            current.flags = flags;
-            {
-                ZoneScopedN("path_get_size");
-                current.size = path_get_size(filePath);
-            }
             done = true;
         }
     } while (!done);
 
     return *this;
-}
\ No newline at end of file
+}
+
+int32_t retro::dirent::size() const noexcept {
+    if (_size == UNKNOWN_SIZE) {
+        ZoneScopedN("path_get_size");
+        _size = path_get_size(path);
+    }
+
+    return _size;
+}
+
+int retro::dirent::flags() const noexcept {
+    if (_flags == UNKNOWN_FLAGS) {
+        ZoneScopedN("path_stat");
+        _flags = path_stat(path);
+    }
+
+    return _flags;
+}
@@ -17,6 +17,7 @@
 #ifndef MELONDS_DS_DIRENT_HPP
 #define MELONDS_DS_DIRENT_HPP
 
+#include <climits>
 #include <cstdint>
 #include <cstring>
 #include <iterator>
@@ -30,20 +31,38 @@ namespace retro {
         return flags & RETRO_VFS_STAT_IS_VALID && !(flags & (RETRO_VFS_STAT_IS_DIRECTORY | RETRO_VFS_STAT_IS_CHARACTER_SPECIAL));
     }
 
+    /// A file found by readdir.
+    /// Its size and type are only looked up (with a stat call) the first time they're asked for,
+    /// since most callers can rule out most files by name or size alone.
     struct dirent {
         char path[PATH_MAX];
-        int32_t size;
-        int flags;
 
-        dirent() {
-            memset((void *) path, 0, sizeof(path));
-            size = 0;
-            flags = 0;
+        dirent() noexcept {
+            clear();
+        }
+
+        /// The file's size in bytes, or -1 if it couldn't be determined.
+        int32_t size() const noexcept;
+
+        /// The file's RETRO_VFS_STAT_* flags, or 0 if it couldn't be stat'ed.
+        int flags() const noexcept;
+
+        bool is_regular_file() const noexcept {
+            return retro::is_regular_file(flags());
         }
 
-        constexpr bool is_regular_file() const noexcept {
-            return retro::is_regular_file(flags);
+        /// Empties the path and forgets the size and type.
+        void clear() noexcept {
+            memset((void *) path, 0, sizeof(path));
+            _size = UNKNOWN_SIZE;
+            _flags = UNKNOWN_FLAGS;
         }
+    private:
+        static constexpr int32_t UNKNOWN_SIZE = INT32_MIN;
+        static constexpr int UNKNOWN_FLAGS = -1;
+
+        mutable int32_t _size;
+        mutable int _flags;
     };
 
     struct dirent_tree {
@@ -86,6 +105,10 @@ namespace retro {
         friend dirent_tree readdir(const std::string& path, bool hidden) noexcept;
     };
 
+    /// Lists the files in the given directory (not recursively).
+    /// Subdirectories are skipped, using the type reported by the directory listing if there is one
+    /// so that they don't need to be stat'ed.
+    /// Other non-regular files (e.g. devices) may still be returned; check dirent::is_regular_file.
     dirent_tree readdir(const std::string& path, bool hidden) noexcept;
 }
 
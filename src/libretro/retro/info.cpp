@@ -16,17 +16,122 @@ Copyright 2023 Jesse Talavera-Greenberg
 
 #include "info.hpp"
 
+#include <cstdlib>
 #include <cstring>
 #include <libretro.h>
 
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <streams/file_stream.h>
+
+#include "environment.hpp"
+#include "tracy.hpp"
+
+void retro::GameInfo::DataDeleter::operator()(const std::byte* data) const noexcept {
+    switch (storage) {
+        case Storage::Owned:
+            free(const_cast<std::byte*>(data));
+            break;
+        case Storage::Mapped:
+#ifdef HAVE_MMAP
+            munmap(const_cast<std::byte*>(data), size);
+#endif
+            break;
+        case Storage::Borrowed:
+            // The frontend owns this data
+            break;
+    }
+}
+
 retro::GameInfo::GameInfo(const retro_game_info& info) noexcept :
     _path(info.path ? info.path : ""),
-    _data(info.data && info.size ? std::make_unique<std::byte[]>(info.size) : nullptr),
-    _size(info.size),
+    _data(nullptr),
+    _size(0),
+    _meta(info.meta ? info.meta : "")
+{
+    if (info.data && info.size) {
+        Copy(info.data, info.size);
+    }
+}
+
+retro::GameInfo::GameInfo(const retro_game_info& info, const retro_game_info_ext* ext) noexcept :
+    _path(info.path ? info.path : ""),
+    _data(nullptr),
+    _size(0),
     _meta(info.meta ? info.meta : "")
 {
-    if (_data) {
-        memcpy(_data.get(), info.data, info.size);
+    ZoneScopedN(TracyFunction);
+
+    if (info.data && info.size) {
+        if (ext && ext->persistent_data && ext->data == info.data) {
+            // If the frontend will keep the data around until the game is unloaded...
+            _data = std::unique_ptr<const std::byte, DataDeleter>(
+                static_cast<const std::byte*>(info.data),
+                DataDeleter { .storage = Storage::Borrowed, .size = info.size }
+            );
+            _size = info.size;
+            retro::debug("Using the frontend's {}-byte copy of \"{}\"", _size, _path);
+        } else {
+            Copy(info.data, info.size);
+        }
+    } else if (!_path.empty()) {
+        // The frontend only gave us a path, so we have to load the content ourselves
+        LoadFromPath();
+    }
+}
+
+void retro::GameInfo::Copy(const void* data, size_t size) noexcept {
+    ZoneScopedN(TracyFunction);
+    void* copy = malloc(size);
+    if (!copy) {
+        retro::error("Failed to allocate {} bytes for \"{}\"", size, _path);
+        return;
     }
+
+    memcpy(copy, data, size);
+    _data = std::unique_ptr<const std::byte, DataDeleter>(static_cast<const std::byte*>(copy), DataDeleter { .storage = Storage::Owned, .size = size });
+    _size = size;
 }
 
+void retro::GameInfo::LoadFromPath() noexcept {
+    ZoneScopedN(TracyFunction);
+
+#ifdef HAVE_MMAP
+    // Mapping the ROM means its pages are only read in when they're needed,
+    // and the OS can evict them again under memory pressure instead of swapping them out
+    if (int fd = open(_path.c_str(), O_RDONLY | O_CLOEXEC); fd >= 0) {
+        struct stat st {};
+        void* mapping = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd); // The mapping stays valid after the descriptor is closed
+
+        if (mapping != MAP_FAILED) {
+            _data = std::unique_ptr<const std::byte, DataDeleter>(static_cast<const std::byte*>(mapping), DataDeleter { .storage = Storage::Mapped, .size = (size_t)st.st_size });
+            _size = st.st_size;
+            retro::debug("Mapped {} bytes of \"{}\"", _size, _path);
+            return;
+        }
+    }
+#endif
+
+    // Not every VFS path is a local file, so fall back to reading the whole thing
+    void* buffer = nullptr;
+    int64_t length = 0;
+    if (!filestream_read_file(_path.c_str(), &buffer, &length) || !buffer || length <= 0) {
+        free(buffer);
+        retro::error("Failed to read the content at \"{}\"", _path);
+        return;
+    }
+
+    // filestream_read_file allocates with malloc, so we can take ownership of its buffer
+    _data = std::unique_ptr<const std::byte, DataDeleter>(static_cast<const std::byte*>(buffer), DataDeleter { .storage = Storage::Owned, .size = (size_t)length });
+    _size = length;
+    retro::debug("Read {} bytes of \"{}\"", _size, _path);
+}
@@ -18,6 +18,7 @@
 #define MELONDSDS_RETRO_GAMEINFO_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -25,21 +26,45 @@
 #include "std/span.hpp"
 
 struct retro_game_info;
+struct retro_game_info_ext;
 
 namespace retro {
 
     class GameInfo {
     public:
+        /// Copies the content's data, if any.
         GameInfo(const retro_game_info& info) noexcept;
 
+        /// Holds onto the content without copying it if possible.
+        /// If the frontend promised to keep the data alive for the whole session, it's used as-is;
+        /// if the frontend only provided a path, the file is memory-mapped (or read if it can't be).
+        /// Otherwise the data is copied.
+        /// If the content couldn't be loaded, GetData() will be empty.
+        GameInfo(const retro_game_info& info, const retro_game_info_ext* ext) noexcept;
+
         std::string_view GetPath() const noexcept { return _path; }
         std::span<const std::byte> GetData() const noexcept {
             return std::span(_data.get(), _size);
         }
         std::string_view GetMeta() const noexcept { return _meta; }
     private:
+        enum class Storage : uint8_t {
+            Owned,
+            Borrowed,
+            Mapped,
+        };
+
+        struct DataDeleter {
+            Storage storage;
+            size_t size;
+            void operator()(const std::byte* data) const noexcept;
+        };
+
+        void Copy(const void* data, size_t size) noexcept;
+        void LoadFromPath() noexcept;
+
         std::string _path;
-        std::unique_ptr<std::byte[]> _data;
+        std::unique_ptr<const std::byte, DataDeleter> _data;
         size_t _size;
         std::string _meta;
     };
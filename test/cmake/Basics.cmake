@@ -73,6 +73,23 @@ add_python_test(
     CONTENT "${NDS_ROM}"
 )
 
+# The frame time printed by these tests can be compared to measure run-ahead's overhead
+add_python_test(
+    NAME "Core runs without run-ahead"
+    TEST_MODULE basics.core_runs_ahead
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_runahead_frames=0"
+    LABELS "benchmark"
+)
+
+add_python_test(
+    NAME "Core runs ahead by 2 frames"
+    TEST_MODULE basics.core_runs_ahead
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_runahead_frames=2"
+    LABELS "benchmark"
+)
+
 add_python_test(
     NAME "Core accepts button input"
     TEST_MODULE basics.core_accepts_button_input
@@ -93,6 +110,22 @@ add_python_test(
     CORE_OPTION melonds_show_cursor=always
 )
 
+add_python_test(
+    NAME "Core accepts button input with late input polling"
+    TEST_MODULE basics.core_accepts_button_input
+    NDS_SYSFILES  # This test needs the NDS system menu
+    CORE_OPTION melonds_lazy_input_polling=enabled
+    TIMEOUT 30
+)
+
+add_python_test(
+    NAME "Core accepts pointer input with late input polling"
+    TEST_MODULE basics.core_accepts_pointer_input
+    NDS_SYSFILES # This test needs the NDS system menu
+    CORE_OPTION melonds_show_cursor=always
+    CORE_OPTION melonds_lazy_input_polling=enabled
+)
+
 add_python_test(
     NAME "Core saves state"
     TEST_MODULE basics.core_saves_state
@@ -105,6 +138,26 @@ add_python_test(
     CONTENT "${NDS_ROM}"
 )
 
+add_python_test(
+    NAME "Synchronized clock follows the host's clock across pauses and savestates"
+    TEST_MODULE basics.core_keeps_rtc_in_sync
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_start_time_mode=sync"
+    TIMEOUT 60
+)
+
+add_python_test(
+    NAME "Fixed clock starts at the configured time"
+    TEST_MODULE basics.core_starts_fixed_clock
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_start_time_mode=fixed"
+    CORE_OPTION "melonds_start_time_absolute_year=2010"
+    CORE_OPTION "melonds_start_time_absolute_month=6"
+    CORE_OPTION "melonds_start_time_absolute_day=15"
+    CORE_OPTION "melonds_start_time_absolute_hour=13"
+    CORE_OPTION "melonds_start_time_absolute_minute=30"
+)
+
 add_python_test(
     NAME "Core exposes emulated RAM"
     TEST_MODULE basics.core_exposes_ram
@@ -337,3 +390,14 @@ add_python_test(
     TEST_MODULE basics.core_gets_power_state
     CONTENT "${NDS_ROM}"
 )
+
+# Frame capture is only enabled to start its writer thread
+add_python_test(
+    NAME "Core names its threads"
+    TEST_MODULE basics.core_names_threads
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_render_mode=software"
+    CORE_OPTION "melonds_threaded_renderer=enabled"
+    CORE_OPTION "melonds_frame_capture=frames"
+    SKIP_RETURN_CODE 77
+)
@@ -259,4 +259,25 @@ add_python_test(
     CORE_OPTION "melonds_firmware_dsi_path=melonDS DS/${DSI_FIRMWARE_NAME}"
     CORE_OPTION "melonds_dsi_nand_path=melonDS DS/${DSI_NAND_NAME}"
     DSI_SYSFILES
+)
+
+add_python_test(
+    NAME "DSiWare save data survives a session that ends without unloading"
+    TEST_MODULE save.core_exports_dsiware_save_without_unload
+    CONTENT "${DSIWARE_ROM}"
+    CORE_OPTION "melonds_console_mode=dsi"
+    CORE_OPTION "melonds_firmware_dsi_path=melonDS DS/${DSI_FIRMWARE_NAME}"
+    CORE_OPTION "melonds_dsi_nand_path=melonDS DS/${DSI_NAND_NAME}"
+    DSI_SYSFILES
+    SKIP_RETURN_CODE 77
+)
+
+add_python_test(
+    NAME "DSiWare sessions don't modify the DSi NAND image"
+    TEST_MODULE save.core_leaves_dsi_nand_unchanged
+    CONTENT "${DSIWARE_ROM}"
+    CORE_OPTION "melonds_console_mode=dsi"
+    CORE_OPTION "melonds_firmware_dsi_path=melonDS DS/${DSI_FIRMWARE_NAME}"
+    CORE_OPTION "melonds_dsi_nand_path=melonDS DS/${DSI_NAND_NAME}"
+    DSI_SYSFILES
 )
\ No newline at end of file
@@ -0,0 +1,45 @@
+add_python_test(
+    NAME "Core captures frames as images (software)"
+    TEST_MODULE capture.core_captures_frames
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_frame_capture=frames"
+    CORE_OPTION "melonds_render_mode=software"
+)
+
+add_python_test(
+    NAME "Core captures frames as raw video (software)"
+    TEST_MODULE capture.core_captures_frames
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_frame_capture=raw"
+    CORE_OPTION "melonds_render_mode=software"
+)
+
+add_python_test(
+    NAME "Core captures frames as images (OpenGL)"
+    TEST_MODULE capture.core_captures_frames
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_frame_capture=frames"
+    CORE_OPTION "melonds_render_mode=opengl"
+    CORE_OPTION "melonds_opengl_resolution=1"
+    REQUIRES_OPENGL
+)
+
+add_python_test(
+    NAME "Core captures frames as raw video (OpenGL)"
+    TEST_MODULE capture.core_captures_frames
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_frame_capture=raw"
+    CORE_OPTION "melonds_render_mode=opengl"
+    CORE_OPTION "melonds_opengl_resolution=1"
+    REQUIRES_OPENGL
+)
+
+add_python_test(
+    NAME "Core discards in-flight frames when capture restarts (OpenGL)"
+    TEST_MODULE capture.core_restarts_capture
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_frame_capture=frames"
+    CORE_OPTION "melonds_render_mode=opengl"
+    CORE_OPTION "melonds_opengl_resolution=1"
+    REQUIRES_OPENGL
+)
@@ -20,6 +20,16 @@ add_python_test(
     NDS_SYSFILES
 )
 
+### Scanning the system directory
+
+# Prints how long startup takes with and without the index
+add_python_test(
+    NAME "Core caches what it finds in the system directory"
+    TEST_MODULE firmware.core_caches_system_file_index
+    NDS_SYSFILES
+    LABELS "benchmark"
+)
+
 ### Ensuring firmware is not overwritten
 
 # See https://github.com/JesseTG/melonds-ds/issues/59
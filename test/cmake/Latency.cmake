@@ -0,0 +1,39 @@
+# These tests print the input latency for each configuration,
+# so that renderers and input settings can be compared.
+# Run-ahead and late polling must each beat the baseline.
+add_python_test(
+    NAME "Input latency with software rendering"
+    TEST_MODULE latency.measure_input_latency
+    CONTENT "${LATENCY_NDS}"
+    CORE_OPTION "melonds_render_mode=software"
+)
+
+add_python_test(
+    NAME "Input latency with threaded software rendering"
+    TEST_MODULE latency.measure_input_latency
+    CONTENT "${LATENCY_NDS}"
+    CORE_OPTION "melonds_render_mode=software"
+    CORE_OPTION "melonds_threaded_renderer=enabled"
+)
+
+add_python_test(
+    NAME "Input latency with OpenGL rendering"
+    TEST_MODULE latency.measure_input_latency
+    CONTENT "${LATENCY_NDS}"
+    CORE_OPTION "melonds_render_mode=opengl"
+    REQUIRES_OPENGL
+)
+
+add_python_test(
+    NAME "Input latency with late input polling"
+    TEST_MODULE latency.measure_input_latency
+    CONTENT "${LATENCY_NDS}"
+    CORE_OPTION "melonds_lazy_input_polling=enabled"
+)
+
+add_python_test(
+    NAME "Input latency with run-ahead"
+    TEST_MODULE latency.measure_input_latency
+    CONTENT "${LATENCY_NDS}"
+    CORE_OPTION "melonds_runahead_frames=1"
+)
@@ -0,0 +1,22 @@
+# The frame time printed by these tests can be compared across builds,
+# since every run sees exactly the same input and starts at the same emulated time
+add_python_test(
+    NAME "Core records and plays back an input movie"
+    TEST_MODULE movie.core_plays_back_movie
+    CONTENT "${NDS_ROM}"
+    LABELS "benchmark"
+)
+
+add_python_test(
+    NAME "Core records and plays back an input movie while the clock is synchronized"
+    TEST_MODULE movie.core_plays_back_movie
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_start_time_mode=sync"
+)
+
+add_python_test(
+    NAME "Core records and plays back an input movie with late input polling"
+    TEST_MODULE movie.core_plays_back_movie
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_lazy_input_polling=enabled"
+)
@@ -0,0 +1,68 @@
+# These tests compare the renderers against each other.
+# Configure with MELONDSDS_HEADLESS_OPENGL=ON to run them without a display or GPU.
+add_python_test(
+    NAME "OpenGL renderer output matches software renderer output"
+    TEST_MODULE opengl.core_matches_software_renderer
+    CONTENT "${NDS_ROM}"
+    REQUIRES_OPENGL
+    TIMEOUT 120
+)
+
+add_python_test(
+    NAME "Renderer benchmark (software)"
+    TEST_MODULE opengl.benchmark_renderer
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_render_mode=software"
+    CORE_OPTION "melonds_start_time_mode=fixed"
+    LABELS "benchmark"
+    TIMEOUT 120
+)
+
+add_python_test(
+    NAME "Renderer benchmark (threaded software)"
+    TEST_MODULE opengl.benchmark_renderer
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_render_mode=software"
+    CORE_OPTION "melonds_threaded_renderer=enabled"
+    CORE_OPTION "melonds_start_time_mode=fixed"
+    LABELS "benchmark"
+    TIMEOUT 120
+)
+
+# Compare against the previous benchmark to see the effect of the thread policy
+add_python_test(
+    NAME "Renderer benchmark (threaded software, performance cores, high priority)"
+    TEST_MODULE opengl.benchmark_renderer
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_render_mode=software"
+    CORE_OPTION "melonds_threaded_renderer=enabled"
+    CORE_OPTION "melonds_start_time_mode=fixed"
+    CORE_OPTION "melonds_thread_affinity=performance"
+    CORE_OPTION "melonds_thread_priority=high"
+    LABELS "benchmark"
+    TIMEOUT 120
+)
+
+add_python_test(
+    NAME "Renderer benchmark (OpenGL, 1x)"
+    TEST_MODULE opengl.benchmark_renderer
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_render_mode=opengl"
+    CORE_OPTION "melonds_opengl_resolution=1"
+    CORE_OPTION "melonds_start_time_mode=fixed"
+    LABELS "benchmark"
+    REQUIRES_OPENGL
+    TIMEOUT 120
+)
+
+add_python_test(
+    NAME "Renderer benchmark (OpenGL, 4x)"
+    TEST_MODULE opengl.benchmark_renderer
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_render_mode=opengl"
+    CORE_OPTION "melonds_opengl_resolution=4"
+    CORE_OPTION "melonds_start_time_mode=fixed"
+    LABELS "benchmark"
+    REQUIRES_OPENGL
+    TIMEOUT 120
+)
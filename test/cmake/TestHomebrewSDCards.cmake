@@ -65,4 +65,32 @@ add_python_test(
     CORE_OPTION "melonds_homebrew_sdcard=enabled"
     CORE_OPTION "melonds_homebrew_sync_sdcard_to_host=disabled"
     WILL_FAIL
-)
\ No newline at end of file
+)
+add_python_test(
+    NAME "Homebrew SD card image reads and writes are buffered"
+    CONTENT "${GODMODE9I_ROM}"
+    TEST_MODULE save.core_buffers_sd_card_io
+    CORE_OPTION "melonds_console_mode=ds"
+    CORE_OPTION "melonds_homebrew_sdcard=enabled"
+    CORE_OPTION "melonds_homebrew_sync_sdcard_to_host=disabled"
+)
+
+add_python_test(
+    NAME "Homebrew SD card image is memory-mapped if it's a local file"
+    CONTENT "${GODMODE9I_ROM}"
+    TEST_MODULE save.core_maps_sd_card_image
+    CORE_OPTION "melonds_console_mode=ds"
+    CORE_OPTION "melonds_homebrew_sdcard=enabled"
+    CORE_OPTION "melonds_homebrew_sync_sdcard_to_host=disabled"
+    SKIP_RETURN_CODE 77
+)
+
+add_python_test(
+    NAME "Homebrew SD card image is created as a sparse file"
+    CONTENT "${GODMODE9I_ROM}"
+    TEST_MODULE save.core_creates_sparse_sd_card_image
+    CORE_OPTION "melonds_console_mode=ds"
+    CORE_OPTION "melonds_homebrew_sdcard=enabled"
+    CORE_OPTION "melonds_homebrew_sync_sdcard_to_host=disabled"
+    SKIP_RETURN_CODE 77
+)
@@ -73,3 +73,44 @@ add_python_test(
     REQUIRES_OPENGL
     NO_SKIP_ERROR_SCREEN
 )
+
+# Forces Mesa's software rasterizer so that the numbers don't depend on the host GPU
+add_python_test(
+    NAME "Core doesn't resend unchanged OpenGL state every frame"
+    TEST_MODULE opengl.core_skips_redundant_gl_calls
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_render_mode=opengl"
+    ENVIRONMENT "LIBGL_ALWAYS_SOFTWARE=1"
+    LABELS "benchmark"
+    REQUIRES_OPENGL
+    TIMEOUT 60
+)
+
+add_python_test(
+    NAME "Core caches OpenGL shader program binaries"
+    TEST_MODULE opengl.core_caches_shader_programs
+    CONTENT "${NDS_ROM}"
+    CORE_OPTION "melonds_render_mode=opengl"
+    LABELS "benchmark"
+    REQUIRES_OPENGL
+    SKIP_RETURN_CODE 77
+    TIMEOUT 60
+)
+
+add_python_test(
+    NAME "Core reports time to first frame after an OpenGL context reset"
+    TEST_MODULE opengl.core_measures_context_reset
+    CONTENT "${NDS_ROM}"
+    LABELS "benchmark"
+    REQUIRES_OPENGL
+    TIMEOUT 30
+)
+
+add_python_test(
+    NAME "Core measures GPU time with OpenGL"
+    TEST_MODULE opengl.core_measures_gpu_time
+    CONTENT "${NDS_ROM}"
+    LABELS "benchmark"
+    REQUIRES_OPENGL
+    TIMEOUT 30
+)
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""
+Generates latency.nds, a tiny homebrew ROM for measuring input latency.
+
+The ROM paints both screens' backdrop red while A is held and black otherwise.
+Like a typical game, it reads KEYINPUT once per frame (on scanline LATCH_LINE)
+and applies the result at the start of the next VBlank,
+so a press shows up in the frame after the one that reads it.
+It's hand-assembled so that it can be rebuilt without a devkitARM toolchain;
+it only supports direct boot, since it has no Nintendo logo.
+
+Usage: latency.py [output path]
+"""
+
+import struct
+import sys
+from pathlib import Path
+
+ARM9_ADDRESS = 0x02000000
+ARM7_ADDRESS = 0x037F8000
+ARM9_ROM_OFFSET = 0x200
+ROM_SIZE = 0x1000
+
+POWCNT1 = 0x04000304
+DISPCNT_A = 0x04000000
+DISPCNT_B = 0x04001000
+KEYINPUT = 0x04000130
+VCOUNT = 0x04000006
+BACKDROP_A = 0x05000000
+BACKDROP_B = 0x05000400
+
+POWER_ALL_2D = (1 << 0) | (1 << 1) | (1 << 9) | (1 << 15)  # LCDs, 2D engine A, 2D engine B, engine A on top
+DISPLAY_MODE_GRAPHICS = 1 << 16  # All layers disabled, so only the backdrop is shown
+RED = 0x001F  # BGR555
+KEY_A = 1 << 0
+LATCH_LINE = 100  # Partway through the visible scanlines, so that late input polling has something to gain
+VBLANK_LINE = 192
+
+
+class Assembler:
+    """Just enough of an ARM assembler for this ROM"""
+
+    def __init__(self, base: int):
+        self.base = base
+        self.code: list[int | tuple[str, int, int]] = []
+        self.literals: list[int] = []
+
+    @property
+    def here(self) -> int:
+        return self.base + len(self.code) * 4
+
+    def ldr_literal(self, rd: int, value: int):
+        if value not in self.literals:
+            self.literals.append(value)
+        self.code.append(("ldr", rd, value))
+
+    def str(self, rd: int, rn: int):
+        self.code.append(0xE5800000 | (rn << 16) | (rd << 12))
+
+    def strh(self, rd: int, rn: int):
+        self.code.append(0xE1C000B0 | (rn << 16) | (rd << 12))
+
+    def ldrh(self, rd: int, rn: int):
+        self.code.append(0xE1D000B0 | (rn << 16) | (rd << 12))
+
+    def tst(self, rn: int, imm8: int):
+        self.code.append(0xE3100000 | (rn << 16) | imm8)
+
+    def cmp(self, rn: int, imm8: int):
+        self.code.append(0xE3500000 | (rn << 16) | imm8)
+
+    def mov_imm(self, rd: int, imm8: int):
+        self.code.append(0xE3A00000 | (rd << 12) | imm8)
+
+    def moveq(self, rd: int, rm: int):
+        self.code.append(0x01A00000 | (rd << 12) | rm)
+
+    def movne_imm(self, rd: int, imm8: int):
+        self.code.append(0x13A00000 | (rd << 12) | imm8)
+
+    def b(self, target: int, condition: int = 0xE):
+        offset = (target - (self.here + 8)) >> 2
+        self.code.append((condition << 28) | 0x0A000000 | (offset & 0xFFFFFF))
+
+    def bne(self, target: int):
+        self.b(target, 0x1)
+
+    def assemble(self) -> bytes:
+        pool = self.base + len(self.code) * 4
+        words = []
+        for i, instruction in enumerate(self.code):
+            if isinstance(instruction, tuple):
+                _, rd, value = instruction
+                address = self.base + i * 4
+                offset = pool + self.literals.index(value) * 4 - (address + 8)
+                assert 0 <= offset < 0x1000
+                instruction = 0xE59F0000 | (rd << 12) | offset
+            words.append(instruction)
+
+        return struct.pack(f"<{len(words) + len(self.literals)}I", *words, *self.literals)
+
+
+def arm9() -> bytes:
+    asm = Assembler(ARM9_ADDRESS)
+    asm.ldr_literal(0, POWCNT1)
+    asm.ldr_literal(1, POWER_ALL_2D)
+    asm.str(1, 0)
+    asm.ldr_literal(0, DISPCNT_A)
+    asm.ldr_literal(1, DISPLAY_MODE_GRAPHICS)
+    asm.str(1, 0)
+    asm.ldr_literal(0, DISPCNT_B)
+    asm.str(1, 0)
+    asm.ldr_literal(2, KEYINPUT)
+    asm.ldr_literal(3, BACKDROP_A)
+    asm.ldr_literal(7, BACKDROP_B)
+    asm.ldr_literal(6, RED)
+    asm.ldr_literal(8, VCOUNT)
+    asm.mov_imm(5, 0)
+
+    loop = asm.here
+    asm.ldrh(9, 8)
+    asm.cmp(9, LATCH_LINE)
+    asm.bne(loop)
+    asm.ldrh(4, 2)  # KEYINPUT is active-low
+    asm.tst(4, KEY_A)
+    asm.moveq(5, 6)  # A is held
+    asm.movne_imm(5, 0)  # A is released
+
+    vblank = asm.here
+    asm.ldrh(9, 8)
+    asm.cmp(9, VBLANK_LINE)
+    asm.bne(vblank)
+    asm.strh(5, 3)
+    asm.strh(5, 7)
+    asm.b(loop)
+
+    return asm.assemble()
+
+
+def arm7() -> bytes:
+    return struct.pack("<I", 0xEAFFFFFE)  # b .
+
+
+def crc16(data: bytes) -> int:
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def build() -> bytes:
+    arm9_binary = arm9()
+    arm7_binary = arm7()
+    arm7_rom_offset = ARM9_ROM_OFFSET + ((len(arm9_binary) + 0x1FF) & ~0x1FF)
+    used_size = arm7_rom_offset + len(arm7_binary)
+
+    header = bytearray(0x200)
+    header[0x000:0x00C] = b"LATENCYTEST\0"
+    header[0x00C:0x010] = b"####"  # Homebrew
+    header[0x010:0x012] = b"00"
+    struct.pack_into("<4I", header, 0x020, ARM9_ROM_OFFSET, ARM9_ADDRESS, ARM9_ADDRESS, len(arm9_binary))
+    struct.pack_into("<4I", header, 0x030, arm7_rom_offset, ARM7_ADDRESS, ARM7_ADDRESS, len(arm7_binary))
+    struct.pack_into("<2I", header, 0x060, 0x00586000, 0x001808F8)  # Port 40001A4h settings (ndstool defaults)
+    struct.pack_into("<2I", header, 0x080, used_size, 0x200)
+    struct.pack_into("<H", header, 0x15E, crc16(header[:0x15E]))
+
+    rom = bytearray(ROM_SIZE)
+    rom[0:0x200] = header
+    rom[ARM9_ROM_OFFSET:ARM9_ROM_OFFSET + len(arm9_binary)] = arm9_binary
+    rom[arm7_rom_offset:arm7_rom_offset + len(arm7_binary)] = arm7_binary
+    return bytes(rom)
+
+
+if __name__ == "__main__":
+    output = Path(sys.argv[1]) if len(sys.argv) > 1 else Path(__file__).parent.parent / "latency.nds"
+    output.write_bytes(build())
+    print(f"Wrote {output}")
@@ -0,0 +1,55 @@
+import calendar
+import time
+from ctypes import CFUNCTYPE, c_int64
+
+import prelude
+
+# melonDS's frame rate
+FRAME_PERIOD = 1 / 59.8261
+
+# SyncedClock::MAX_DRIFT
+MAX_DRIFT = 2
+
+PAUSE_SECONDS = 3
+
+
+def host_time() -> int:
+    return calendar.timegm(time.localtime())
+
+
+with prelude.session() as session:
+    rtc_time = session.get_proc_address("melondsds_rtc_time", CFUNCTYPE(c_int64))
+    assert rtc_time is not None, "melondsds_rtc_time not found"
+
+    last_rtc = None
+
+    def run_frames(count: int, event: str):
+        global last_rtc
+        start = time.monotonic()
+        for i in range(count):
+            # Run in real time, or else the RTC would count emulated seconds faster than the host does
+            delay = start + i * FRAME_PERIOD - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+
+            session.run()
+            rtc = rtc_time()
+            host = host_time()
+            assert last_rtc is None or rtc >= last_rtc, f"RTC went back from {last_rtc} to {rtc} {event}"
+            assert abs(rtc - host) <= MAX_DRIFT, f"RTC is {rtc - host}s off from the host's clock {event}"
+            last_rtc = rtc
+
+    run_frames(180, "while running")
+
+    # The frontend stops calling retro_run while paused
+    time.sleep(PAUSE_SECONDS)
+    run_frames(60, "after a pause")
+
+    buffer = bytearray(session.core.serialize_size())
+    assert session.core.serialize(buffer)
+
+    run_frames(180, "before loading a state")
+
+    # The savestate's RTC is a few seconds behind now
+    assert session.core.unserialize(buffer)
+    run_frames(60, "after loading a state")
@@ -0,0 +1,40 @@
+import os
+import shutil
+import sys
+
+import prelude
+
+SKIP = 77
+TASK_DIR = "/proc/self/task"
+EXPECTED_NAMES = {"melonDS render", "melonDS capture"}
+
+
+def thread_names() -> set[str]:
+    names = set()
+    for tid in os.listdir(TASK_DIR):
+        try:
+            with open(os.path.join(TASK_DIR, tid, "comm")) as f:
+                names.add(f.read().strip())
+        except FileNotFoundError:
+            pass  # The thread exited while we were looking
+    return names
+
+
+if not os.path.isdir(TASK_DIR):
+    print(f"{TASK_DIR} isn't available on this platform, skipping")
+    sys.exit(SKIP)
+
+with prelude.session() as session:
+    for i in range(10):
+        session.run()
+
+    names = thread_names()
+
+# Don't leave the capture that started the writer thread in the save directory
+for entry in os.listdir(prelude.core_save_dir):
+    if entry.endswith(b".frames"):
+        shutil.rmtree(os.path.join(prelude.core_save_dir, entry))
+
+print(f"Threads: {sorted(names)}")
+missing = EXPECTED_NAMES - names
+assert not missing, f"Expected threads named {sorted(missing)}"
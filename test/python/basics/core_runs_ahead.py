@@ -0,0 +1,36 @@
+import time
+from typing import cast
+
+from libretro import Session, ArrayAudioDriver, Screenshot
+
+import prelude
+
+WARMUP_FRAMES = 60
+BENCHMARK_FRAMES = 300
+
+session: Session
+with prelude.session() as session:
+    audio = cast(ArrayAudioDriver, session.audio)
+    for i in range(WARMUP_FRAMES):
+        session.run()
+
+    start = time.perf_counter_ns()
+    for i in range(BENCHMARK_FRAMES):
+        session.run()
+    elapsed = time.perf_counter_ns() - start
+
+    print(f"Ran {BENCHMARK_FRAMES} frames in {elapsed / 1e6:.2f}ms ({elapsed / BENCHMARK_FRAMES / 1e6:.3f}ms per frame)")
+
+    frame = session.video.screenshot()
+    assert isinstance(frame, Screenshot)
+    assert any(frame.data)
+
+    assert audio.buffer is not None
+    assert any(b != 0 for b in audio.buffer)
+    # The frames we ran ahead shouldn't have eaten the audio
+
+    size = session.core.serialize_size()
+    buffer = bytearray(size)
+    assert session.core.serialize(buffer)
+    assert session.core.unserialize(buffer)
+    # Run-ahead shouldn't interfere with the frontend's own savestates
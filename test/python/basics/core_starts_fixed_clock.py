@@ -0,0 +1,37 @@
+import calendar
+from ctypes import CFUNCTYPE, c_int64
+
+import prelude
+
+# melonDS's frame rate
+FRAMES_PER_SECOND = 59.8261
+SECONDS = 10
+
+options = prelude.options
+expected = calendar.timegm((
+    int(options[b"melonds_start_time_absolute_year"]),
+    int(options[b"melonds_start_time_absolute_month"]),
+    int(options[b"melonds_start_time_absolute_day"]),
+    int(options[b"melonds_start_time_absolute_hour"]),
+    int(options[b"melonds_start_time_absolute_minute"]),
+    0, 0, 0, 0
+))
+
+with prelude.session() as session:
+    rtc_time = session.get_proc_address("melondsds_rtc_time", CFUNCTYPE(c_int64))
+    assert rtc_time is not None, "melondsds_rtc_time not found"
+
+    session.run()
+    first = rtc_time()
+
+    # Frames aren't paced here, so this takes much less than SECONDS of wall time
+    for i in range(round(SECONDS * FRAMES_PER_SECOND)):
+        session.run()
+
+    last = rtc_time()
+
+assert expected <= first <= expected + 1, f"Expected the RTC to start at {expected}, got {first}"
+
+# The clock should follow emulated time, not the host's
+elapsed = last - first
+assert SECONDS - 1 <= elapsed <= SECONDS + 1, f"Expected the RTC to advance by {SECONDS}s, got {elapsed}s"
@@ -0,0 +1,62 @@
+import os
+from ctypes import CFUNCTYPE, c_uint64
+
+from libretro import ModernGlVideoDriver
+
+import prelude
+
+FRAMES = 120
+# The OpenGL renderer reads frames back a few frames late,
+# so the last few that it presents before capture stops are never written
+MAX_FRAMES_IN_FLIGHT = 3
+SCREEN_WIDTH = 256
+SCREEN_HEIGHT = 192
+
+mode = prelude.options[b"melonds_frame_capture"]
+renderer = prelude.options.get(b"melonds_render_mode", b"software")
+
+builder = prelude.builder()
+if renderer == b"opengl":
+    builder = builder.with_video(ModernGlVideoDriver)
+
+with builder.build() as session:
+    frames_written = session.get_proc_address("melondsds_capture_frames_written", CFUNCTYPE(c_uint64))
+    frames_dropped = session.get_proc_address("melondsds_capture_frames_dropped", CFUNCTYPE(c_uint64))
+    assert frames_written is not None, "melondsds_capture_frames_written not found"
+    assert frames_dropped is not None, "melondsds_capture_frames_dropped not found"
+
+    for i in range(FRAMES):
+        session.run()
+
+    # Stopping the capture waits for the writer thread to finish
+    session.options.variables["melonds_frame_capture"] = b"disabled"
+    session.run()
+
+    written = frames_written()
+    dropped = frames_dropped()
+
+print(f"Captured {written} frames ({dropped} dropped) in {mode.decode()} mode with the {renderer.decode()} renderer")
+assert written > 0, "Expected at least one frame to be captured"
+assert written + dropped + MAX_FRAMES_IN_FLIGHT >= FRAMES, f"Expected about {FRAMES} frames, got {written} written and {dropped} dropped"
+
+captures = [f for f in os.listdir(prelude.core_save_dir) if f.endswith(b".frames") or f.endswith(b".raw")]
+assert len(captures) == 1, f"Expected exactly one capture in {prelude.core_save_dir}, found {captures}"
+capture_path = os.path.join(prelude.core_save_dir, captures[0])
+
+if mode == b"frames":
+    assert os.path.isdir(capture_path), f"{capture_path} should be a directory"
+    images = sorted(f for f in os.listdir(capture_path) if f.endswith(b".ppm"))
+    assert len(images) == written, f"Expected {written} images in {capture_path}, found {len(images)}"
+
+    with open(os.path.join(capture_path, images[0]), "rb") as f:
+        data = f.read()
+
+    header = f"P6\n{SCREEN_WIDTH} {SCREEN_HEIGHT * 2}\n255\n".encode()
+    assert data.startswith(header), f"Unexpected PPM header {data[:len(header)]!r}"
+    assert len(data) == len(header) + SCREEN_WIDTH * SCREEN_HEIGHT * 2 * 3
+elif mode == b"raw":
+    frame_size = SCREEN_WIDTH * SCREEN_HEIGHT * 2 * 4
+    size = os.path.getsize(capture_path)
+    assert size == written * frame_size, f"Expected {written} frames of {frame_size} bytes, got {size} bytes"
+else:
+    raise ValueError(f"Unexpected capture mode {mode!r}")
@@ -0,0 +1,47 @@
+import os
+import shutil
+from ctypes import CFUNCTYPE, c_uint64
+
+from libretro import ModernGlVideoDriver
+
+import prelude
+
+FIRST_FRAMES = 120
+SECOND_FRAMES = 30
+
+builder = prelude.builder()
+if prelude.options.get(b"melonds_render_mode", b"software") == b"opengl":
+    builder = builder.with_video(ModernGlVideoDriver)
+
+with builder.build() as session:
+    frames_written = session.get_proc_address("melondsds_capture_frames_written", CFUNCTYPE(c_uint64))
+    assert frames_written is not None, "melondsds_capture_frames_written not found"
+
+    for i in range(FIRST_FRAMES):
+        session.run()
+
+    # Stop capturing while some frames are still being read back...
+    session.options.variables["melonds_frame_capture"] = b"disabled"
+    session.run()
+
+    captures = [f for f in os.listdir(prelude.core_save_dir) if f.endswith(b".frames")]
+    assert len(captures) == 1, f"Expected exactly one capture in {prelude.core_save_dir}, found {captures}"
+    capture_path = os.path.join(prelude.core_save_dir, captures[0])
+    shutil.rmtree(capture_path)
+
+    # ...then start a new capture, which reuses the same directory
+    session.options.variables["melonds_frame_capture"] = b"frames"
+    for i in range(SECOND_FRAMES):
+        session.run()
+
+    session.options.variables["melonds_frame_capture"] = b"disabled"
+    session.run()
+    written = frames_written()
+
+images = sorted(f for f in os.listdir(capture_path) if f.endswith(b".ppm"))
+print(f"Second capture wrote {written} frames: {images[0]!r}..{images[-1]!r}")
+assert len(images) == written, f"Expected {written} images in {capture_path}, found {len(images)}"
+
+for image in images:
+    number = int(image.removesuffix(b".ppm"))
+    assert number < SECOND_FRAMES, f"{image!r} was left over from the first capture"
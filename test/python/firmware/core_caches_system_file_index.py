@@ -0,0 +1,41 @@
+import os
+import time
+from ctypes import CFUNCTYPE, c_uint64
+
+from libretro import Session
+
+import prelude
+
+index_path = os.path.join(prelude.core_save_dir, b"sysfiles.index")
+if os.path.exists(index_path):
+    os.remove(index_path)
+
+
+def scan():
+    start = time.perf_counter_ns()
+    session: Session
+    with prelude.session() as session:
+        elapsed = time.perf_counter_ns() - start
+        hits = session.get_proc_address("melondsds_sysfile_index_hits", CFUNCTYPE(c_uint64))
+        misses = session.get_proc_address("melondsds_sysfile_index_misses", CFUNCTYPE(c_uint64))
+        assert hits is not None, "melondsds_sysfile_index_hits not found"
+        assert misses is not None, "melondsds_sysfile_index_misses not found"
+
+        definition = session.options.definitions[b"melonds_firmware_nds_path"]
+        assert definition is not None, "melonds_firmware_nds_path should be defined"
+        values = [v.value for v in definition.values]
+
+        return elapsed, hits(), misses(), values
+
+
+cold_time, cold_hits, cold_misses, cold_values = scan()
+print(f"Cold start took {cold_time / 1e6:.2f}ms ({cold_hits} cached, {cold_misses} inspected)")
+assert cold_hits == 0, f"Expected no index hits without an index, got {cold_hits}"
+assert cold_misses > 0, "Expected the core to inspect the firmware in the system directory"
+assert os.path.isfile(index_path), f"Expected the core to write its system file index to {index_path}"
+
+warm_time, warm_hits, warm_misses, warm_values = scan()
+print(f"Warm start took {warm_time / 1e6:.2f}ms ({warm_hits} cached, {warm_misses} inspected)")
+assert warm_misses == 0, f"Expected every system file to come from the index, but {warm_misses} were inspected"
+assert warm_hits == cold_misses, f"Expected {cold_misses} index hits, got {warm_hits}"
+assert warm_values == cold_values, f"Expected the same firmware options with and without the index ({cold_values} vs {warm_values})"
@@ -0,0 +1,72 @@
+import itertools
+import sys
+from ctypes import CFUNCTYPE, c_uint16
+
+if sys.version_info >= (3, 12):
+    from itertools import batched
+else:
+    from more_itertools import batched
+
+from libretro import JoypadState, Screenshot, Session
+
+import prelude
+
+# Requires test/nds/latency.nds, which paints both screens red while A is held.
+# Latency is the number of extra video_refresh calls it takes for the press to show up;
+# 0 means the press is visible in the same frame that first reported it.
+PRESS_FRAME = 120
+
+# The ROM reads KEYINPUT on this scanline and applies it at the next VBlank,
+# so without run-ahead a press shows up one frame later
+LATCH_LINE = 100
+BASELINE_LATENCY = 1
+SCANLINES = 263
+
+
+def generate_input():
+    yield from itertools.repeat(0, PRESS_FRAME)
+    yield from itertools.repeat(JoypadState(a=True))
+
+
+def is_red(frame: Screenshot) -> bool:
+    # XRGB8888, so the bytes are stored as BGRX
+    pixels = tuple(batched(frame.data, 4))
+    red = sum(1 for b, g, r, _ in pixels if r > 0x80 and g < 0x40 and b < 0x40)
+    return red > len(pixels) // 2
+
+
+configuration = ", ".join(f"{k.decode()}={v.decode()}" for k, v in sorted(prelude.options.items())) or "defaults"
+runahead_frames = int(prelude.options.get(b"melonds_runahead_frames", b"0"))
+late_polling = prelude.options.get(b"melonds_lazy_input_polling") == b"enabled"
+expected_latency = max(BASELINE_LATENCY - runahead_frames, 0)
+
+session: Session
+with prelude.builder().with_input(generate_input).build() as session:
+    input_poll_scanline = session.get_proc_address("melondsds_input_poll_scanline", CFUNCTYPE(c_uint16))
+    assert input_poll_scanline is not None, "melondsds_input_poll_scanline not found"
+
+    for i in range(PRESS_FRAME):
+        session.run()
+
+    assert not is_red(session.video.screenshot()), "The screen turned red before A was pressed"
+
+    input_age = None
+    for latency in range(BASELINE_LATENCY + 1):
+        session.run()
+        if input_age is None:
+            # How many scanlines old the press was by the time the game read it
+            input_age = (LATCH_LINE - input_poll_scanline()) % SCANLINES
+
+        if is_red(session.video.screenshot()):
+            break
+    else:
+        raise AssertionError(f"The button press didn't appear within {BASELINE_LATENCY} frames ({configuration})")
+
+print(f"Input latency: {latency} frame(s), polled {input_age} scanline(s) before the game read it ({configuration})")
+
+assert latency == expected_latency, f"Expected {expected_latency} frame(s) of latency, got {latency} ({configuration})"
+
+if late_polling:
+    assert input_age == 0, f"Late polling should poll input when the game reads it, not {input_age} scanline(s) earlier"
+else:
+    assert input_age > 0, f"Input should be polled before the frame starts ({configuration})"
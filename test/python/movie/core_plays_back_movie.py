@@ -0,0 +1,59 @@
+import hashlib
+import itertools
+import os
+import time
+from math import sin, cos, pi
+
+from libretro import JoypadState, Point, Pointer, Screenshot
+
+import prelude
+
+FRAMES = 600
+CHECKPOINT_INTERVAL = 60
+# Playback starts at the beginning of the movie regardless of when the core is loaded,
+# so the recorded run and the played-back run should produce identical frames.
+
+
+def generate_input():
+    yield from itertools.repeat(0, 240)
+    yield JoypadState(a=True)
+    yield from itertools.repeat(0, 60)
+
+    for i in range(120):
+        angle = pi * 2 * i / 120
+        yield Pointer(int(cos(angle) * 0x3fff), int(sin(angle) * 0x3fff), i % 20 < 10)
+
+    yield from itertools.repeat(JoypadState(start=True, down=True), 30)
+    yield from itertools.repeat(0)
+
+
+def run(mode: bytes, input_generator) -> tuple[list[str], float]:
+    options = {**prelude.options, b"melonds_movie_mode": mode}
+    hashes = []
+    with prelude.builder().with_options(options).with_input(input_generator).build() as session:
+        start = time.perf_counter_ns()
+        for i in range(FRAMES):
+            session.run()
+            if i % CHECKPOINT_INTERVAL == CHECKPOINT_INTERVAL - 1:
+                frame = session.video.screenshot()
+                assert isinstance(frame, Screenshot)
+                hashes.append(hashlib.sha256(frame.data).hexdigest())
+        elapsed = time.perf_counter_ns() - start
+
+    return hashes, elapsed / FRAMES / 1e6
+
+
+recorded, record_ms = run(b"record", generate_input)
+
+movie_files = [f for f in os.listdir(prelude.core_save_dir) if f.endswith(b".mdsmovie")]
+assert len(movie_files) == 1, f"Expected exactly one movie in {prelude.core_save_dir}, found {movie_files}"
+movie_path = os.path.join(prelude.core_save_dir, movie_files[0])
+assert os.path.getsize(movie_path) > 0
+
+played, play_ms = run(b"play", lambda: itertools.repeat(0))
+# The player's input should be ignored during playback
+
+print(f"Recorded {FRAMES} frames at {record_ms:.3f}ms per frame")
+print(f"Played {FRAMES} frames at {play_ms:.3f}ms per frame")
+
+assert recorded == played, f"Playback diverged from the recording:\n{recorded}\n{played}"
@@ -0,0 +1,19 @@
+import time
+
+import prelude
+
+WARMUP_FRAMES = 60
+MEASURED_FRAMES = 1200
+
+configuration = ", ".join(f"{k.decode()}={v.decode()}" for k, v in sorted(prelude.options.items())) or "defaults"
+
+with prelude.session() as session:
+    for i in range(WARMUP_FRAMES):
+        session.run()
+
+    start = time.perf_counter()
+    for i in range(MEASURED_FRAMES):
+        session.run()
+    elapsed = time.perf_counter() - start
+
+print(f"{MEASURED_FRAMES / elapsed:.1f} FPS ({elapsed * 1000 / MEASURED_FRAMES:.3f}ms/frame) with {configuration}")
@@ -0,0 +1,53 @@
+import os
+import sys
+import time
+from ctypes import CFUNCTYPE, c_uint32
+
+from libretro import ModernGlVideoDriver
+
+import prelude
+
+SKIP = 77
+CACHE_PATH = os.path.join(prelude.core_save_dir, b"melondsds_screen.glprogram")
+
+
+def start_session() -> tuple[float, int, int]:
+    start = time.perf_counter()
+    with prelude.builder().with_video(ModernGlVideoDriver).build() as session:
+        session.run()
+        elapsed = time.perf_counter() - start
+
+        hits = session.get_proc_address("melondsds_render_shader_cache_hits", CFUNCTYPE(c_uint32))
+        misses = session.get_proc_address("melondsds_render_shader_cache_misses", CFUNCTYPE(c_uint32))
+        assert hits is not None, "melondsds_render_shader_cache_hits not found"
+        assert misses is not None, "melondsds_render_shader_cache_misses not found"
+
+        return elapsed, hits(), misses()
+
+
+assert not os.path.exists(CACHE_PATH), f"{CACHE_PATH} shouldn't exist before the first launch"
+
+cold_time, cold_hits, cold_misses = start_session()
+if cold_hits == 0 and cold_misses == 0:
+    print("This OpenGL driver doesn't support program binaries, skipping")
+    sys.exit(SKIP)
+
+assert cold_hits == 0, f"Expected no cache hits on the first launch, got {cold_hits}"
+assert cold_misses > 0, "Expected a cache miss on the first launch"
+assert os.path.isfile(CACHE_PATH), f"Expected the first launch to create {CACHE_PATH}"
+
+warm_time, warm_hits, warm_misses = start_session()
+assert warm_hits > 0, "Expected a cache hit on the second launch"
+assert warm_misses == 0, f"Expected no cache misses on the second launch, got {warm_misses}"
+
+print(f"Time to first frame: {cold_time * 1000:.1f}ms with a cold cache, {warm_time * 1000:.1f}ms with a warm cache")
+
+# Simulate a driver update by clobbering the cache key;
+# the core should notice and recompile instead of using the stale binary
+with open(CACHE_PATH, "r+b") as f:
+    f.seek(8)
+    f.write(b"\xFF" * 8)
+
+_, stale_hits, stale_misses = start_session()
+assert stale_hits == 0, f"Expected the stale binary to be ignored, got {stale_hits} hit(s)"
+assert stale_misses > 0, "Expected the stale binary to be recompiled"
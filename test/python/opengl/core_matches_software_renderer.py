@@ -0,0 +1,77 @@
+import hashlib
+import itertools
+
+from libretro import JoypadState, ModernGlVideoDriver, Screenshot
+
+import prelude
+
+FRAMES = 600
+CHECKPOINT_INTERVAL = 60
+PRESS_FRAME = 150
+# The renderers expand the DS's 6-bit color channels to 8 bits slightly differently
+CHANNEL_TOLERANCE = 8
+# ...and rasterize polygon edges a little differently, so allow for some 3D fringe
+MAX_MISMATCHED_PIXELS = 0.05
+# A frame with fewer colors than this is probably blank or a plain 2D screen,
+# which would make the comparison meaningless
+MIN_DISTINCT_COLORS = 16
+
+
+def generate_input():
+    yield from itertools.repeat(0, PRESS_FRAME)
+    yield from itertools.repeat(JoypadState(a=True))
+
+
+def capture(renderer: bytes) -> list[Screenshot]:
+    options = {
+        **prelude.options,
+        b"melonds_render_mode": renderer,
+        b"melonds_opengl_resolution": b"1",
+        b"melonds_opengl_filtering": b"nearest",
+        b"melonds_start_time_mode": b"fixed",
+    }
+
+    builder = prelude.builder().with_options(options).with_input(generate_input)
+    if renderer == b"opengl":
+        builder = builder.with_video(ModernGlVideoDriver)
+
+    frames = []
+    with builder.build() as session:
+        for i in range(FRAMES):
+            session.run()
+            if i % CHECKPOINT_INTERVAL == CHECKPOINT_INTERVAL - 1:
+                frame = session.video.screenshot()
+                assert isinstance(frame, Screenshot), f"Expected a screenshot from the {renderer.decode()} renderer"
+                frames.append(frame)
+
+    return frames
+
+
+def mismatched_pixels(a: Screenshot, b: Screenshot) -> float:
+    assert len(a.data) == len(b.data), f"Frames differ in size ({len(a.data)} vs {len(b.data)} bytes)"
+    mismatched = 0
+    for i in range(0, len(a.data), 4):
+        if any(abs(a.data[i + c] - b.data[i + c]) > CHANNEL_TOLERANCE for c in range(3)):
+            mismatched += 1
+
+    return mismatched / (len(a.data) // 4)
+
+
+def distinct_colors(frame: Screenshot) -> int:
+    return len({bytes(frame.data[i:i + 3]) for i in range(0, len(frame.data), 4)})
+
+
+software = capture(b"software")
+opengl = capture(b"opengl")
+
+assert any(distinct_colors(s) >= MIN_DISTINCT_COLORS for s in software), \
+    f"The test content never drew more than {MIN_DISTINCT_COLORS} colors, so there's nothing to compare"
+
+for i, (s, g) in enumerate(zip(software, opengl, strict=True)):
+    frame = (i + 1) * CHECKPOINT_INTERVAL
+    software_hash = hashlib.sha256(s.data).hexdigest()
+    opengl_hash = hashlib.sha256(g.data).hexdigest()
+    mismatch = mismatched_pixels(s, g)
+    print(f"Frame {frame}: software={software_hash[:16]} opengl={opengl_hash[:16]} mismatched={mismatch:.2%}")
+
+    assert mismatch <= MAX_MISMATCHED_PIXELS, f"OpenGL output differs from software output at frame {frame} ({mismatch:.2%} of pixels)"
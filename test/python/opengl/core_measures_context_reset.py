@@ -0,0 +1,66 @@
+from ctypes import CFUNCTYPE, c_uint32, c_uint64
+
+from libretro import ModernGlVideoDriver
+
+import prelude
+
+options = {
+    b"melonds_render_mode": b"opengl",
+}
+
+with prelude.builder().with_options(options).with_video(ModernGlVideoDriver).build() as session:
+    context_resets = session.get_proc_address("melondsds_render_context_resets", CFUNCTYPE(c_uint32))
+    context_reuses = session.get_proc_address("melondsds_render_context_reuses", CFUNCTYPE(c_uint32))
+    shader_cache_hits = session.get_proc_address("melondsds_render_shader_cache_hits", CFUNCTYPE(c_uint32))
+    shader_cache_misses = session.get_proc_address("melondsds_render_shader_cache_misses", CFUNCTYPE(c_uint32))
+    simulate_context_reset = session.get_proc_address("melondsds_render_simulate_context_reset", CFUNCTYPE(None))
+    reset_to_first_frame = session.get_proc_address("melondsds_render_context_reset_to_first_frame_us", CFUNCTYPE(c_uint64))
+    assert context_resets is not None, "melondsds_render_context_resets not found"
+    assert context_reuses is not None, "melondsds_render_context_reuses not found"
+    assert shader_cache_hits is not None, "melondsds_render_shader_cache_hits not found"
+    assert shader_cache_misses is not None, "melondsds_render_shader_cache_misses not found"
+    assert simulate_context_reset is not None, "melondsds_render_simulate_context_reset not found"
+    assert reset_to_first_frame is not None, "melondsds_render_context_reset_to_first_frame_us not found"
+
+    for i in range(3):
+        session.run()
+
+    assert context_resets() > 0, "The OpenGL context was never reset"
+    initial = reset_to_first_frame()
+    assert initial > 0, "Time to first frame wasn't recorded"
+
+    # Reset the context without destroying it first,
+    # like a frontend that preserved it across a video driver reinit
+    resets_before = context_resets()
+    reuses_before = context_reuses()
+    hits_before = shader_cache_hits()
+    misses_before = shader_cache_misses()
+    simulate_context_reset()
+    for i in range(3):
+        session.run()
+
+    preserved = reset_to_first_frame()
+    assert context_resets() == resets_before + 1, "The context reset callback wasn't counted"
+    assert context_reuses() == reuses_before + 1, "The core didn't reuse its resources after a context reset without a destroy"
+    assert shader_cache_hits() == hits_before, f"The shader cache was consulted ({shader_cache_hits() - hits_before} hits) after reusing the context"
+    assert shader_cache_misses() == misses_before, f"Shaders were recompiled ({shader_cache_misses() - misses_before} misses) after reusing the context"
+
+    # Switching renderers at runtime creates a new context,
+    # which is the worst case for a context reset
+    session.options.variables["melonds_render_mode"] = b"software"
+    for i in range(3):
+        session.run()
+
+    session.options.variables["melonds_render_mode"] = b"opengl"
+    for i in range(3):
+        session.run()
+
+    after_switch = reset_to_first_frame()
+    assert after_switch > 0, "Time to first frame wasn't recorded after switching renderers"
+
+    print(
+        f"Time to first frame after context reset: {initial / 1000:.1f}ms at startup, "
+        f"{preserved / 1000:.1f}ms with a preserved context, "
+        f"{after_switch / 1000:.1f}ms after switching renderers"
+    )
+    print(f"Context resets: {context_resets()}, reused: {context_reuses()}")
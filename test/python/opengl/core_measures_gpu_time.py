@@ -0,0 +1,36 @@
+from ctypes import CFUNCTYPE, c_uint64
+
+from libretro import ModernGlVideoDriver
+
+import prelude
+
+FRAMES = 60
+
+options = {
+    **prelude.options,
+    b"melonds_render_mode": b"opengl",
+    b"melonds_opengl_gpu_timing": b"enabled",
+}
+
+with prelude.builder().with_options(options).with_video(ModernGlVideoDriver).build() as session:
+    gpu_emulation_ns = session.get_proc_address("melondsds_render_gpu_emulation_ns", CFUNCTYPE(c_uint64))
+    gpu_presentation_ns = session.get_proc_address("melondsds_render_gpu_presentation_ns", CFUNCTYPE(c_uint64))
+    assert gpu_emulation_ns is not None, "melondsds_render_gpu_emulation_ns not found"
+    assert gpu_presentation_ns is not None, "melondsds_render_gpu_presentation_ns not found"
+
+    for i in range(FRAMES):
+        session.run()
+
+    emulation = gpu_emulation_ns()
+    presentation = gpu_presentation_ns()
+    print(f"GPU time: emulation={emulation / 1e6:.3f}ms, presentation={presentation / 1e6:.3f}ms")
+
+    assert emulation > 0, "Expected the emulator's GPU work to be timed"
+    assert presentation > 0, "Expected the presentation pass to be timed"
+
+    session.options.variables["melonds_opengl_gpu_timing"] = b"disabled"
+    for i in range(3):
+        session.run()
+
+    assert gpu_emulation_ns() == 0, "GPU timing should stop reporting results once disabled"
+    assert gpu_presentation_ns() == 0, "GPU timing should stop reporting results once disabled"
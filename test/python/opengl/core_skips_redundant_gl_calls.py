@@ -0,0 +1,48 @@
+import time
+from ctypes import CFUNCTYPE, c_uint64
+from typing import cast
+
+from libretro import ModernGlVideoDriver
+
+import prelude
+
+WARMUP_FRAMES = 120
+MEASURED_FRAMES = 600
+
+with prelude.builder().with_video(ModernGlVideoDriver).build() as session:
+    video = cast(ModernGlVideoDriver, session.video)
+    assert isinstance(video, ModernGlVideoDriver), f"Expected ModernGlVideoDriver, got {type(video).__name__}"
+
+    frames_presented = session.get_proc_address("melondsds_render_frames_presented", CFUNCTYPE(c_uint64))
+    uniform_uploads = session.get_proc_address("melondsds_render_uniform_uploads", CFUNCTYPE(c_uint64))
+    texture_parameter_updates = session.get_proc_address("melondsds_render_texture_parameter_updates", CFUNCTYPE(c_uint64))
+    assert frames_presented is not None, "melondsds_render_frames_presented not found"
+    assert uniform_uploads is not None, "melondsds_render_uniform_uploads not found"
+    assert texture_parameter_updates is not None, "melondsds_render_texture_parameter_updates not found"
+
+    for i in range(WARMUP_FRAMES):
+        session.run()
+
+    presented_before = frames_presented()
+    uploads_before = uniform_uploads()
+    tex_updates_before = texture_parameter_updates()
+    assert presented_before > 0, "The OpenGL renderer didn't present any frames during warmup"
+
+    start = time.perf_counter()
+    for i in range(MEASURED_FRAMES):
+        session.run()
+    elapsed = time.perf_counter() - start
+
+    presented = frames_presented() - presented_before
+    uploads = uniform_uploads() - uploads_before
+    tex_updates = texture_parameter_updates() - tex_updates_before
+
+    print(f"Presented {presented} frames in {elapsed:.3f}s ({elapsed * 1000 / MEASURED_FRAMES:.3f}ms/frame)")
+    print(f"Uniform buffer uploads: {uploads}, texture parameter updates: {tex_updates}")
+
+    assert presented == MEASURED_FRAMES, f"Expected {MEASURED_FRAMES} presented frames, got {presented}"
+
+    # Nothing touches the screen, the layout, or the config here,
+    # so none of the presentation state should have been resent
+    assert uploads == 0, f"Expected no uniform buffer uploads for unchanged state, got {uploads}"
+    assert tex_updates == 0, f"Expected no texture parameter updates for unchanged state, got {tex_updates}"
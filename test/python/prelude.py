@@ -2,6 +2,34 @@ import os
 import shutil
 import sys
 
+
+def _force_gl_backend(backend: str):
+    # libretro.py creates its OpenGL context through moderngl,
+    # which would otherwise pick a backend that needs a display (e.g. GLX).
+    # This has to happen before libretro is imported,
+    # in case it binds moderngl's functions at import time.
+    import moderngl
+
+    create_context = moderngl.create_context
+
+    def create_headless_context(*args, **kwargs):
+        kwargs["standalone"] = True
+        kwargs.setdefault("backend", backend)
+        return create_context(*args, **kwargs)
+
+    def create_headless_standalone_context(*args, **kwargs):
+        return create_headless_context(*args, **kwargs)
+
+    moderngl.create_context = create_headless_context
+    moderngl.create_standalone_context = create_headless_standalone_context
+    print(f"Using headless OpenGL backend: {backend}")
+
+
+# Set by the test suite's MELONDSDS_HEADLESS_OPENGL option
+gl_backend = os.getenv("MELONDSDS_GL_BACKEND")
+if gl_backend:
+    _force_gl_backend(gl_backend)
+
 import libretro
 from libretro import SubsystemContent, SessionBuilder, TempDirPathDriver
 
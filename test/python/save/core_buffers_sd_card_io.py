@@ -0,0 +1,21 @@
+from ctypes import CFUNCTYPE, c_uint64
+
+import prelude
+
+FRAMES = 300
+
+with prelude.session() as session:
+    file_operations = session.get_proc_address("melondsds_file_operations", CFUNCTYPE(c_uint64))
+    vfs_operations = session.get_proc_address("melondsds_file_vfs_operations", CFUNCTYPE(c_uint64))
+    assert file_operations is not None, "melondsds_file_operations not found"
+    assert vfs_operations is not None, "melondsds_file_vfs_operations not found"
+
+    for i in range(FRAMES):
+        session.run()
+
+    operations = file_operations()
+    vfs = vfs_operations()
+
+print(f"melonDS made {operations} file operations, served by {vfs} VFS calls")
+assert operations > 0, "Expected the SD card image to be read or written"
+assert vfs < operations, f"Expected fewer VFS calls than file operations, got {vfs} for {operations}"
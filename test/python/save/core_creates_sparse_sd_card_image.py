@@ -0,0 +1,32 @@
+import os
+import sys
+from ctypes import CFUNCTYPE, c_uint64
+
+import prelude
+
+SKIP = 77
+FRAMES = 120
+
+if os.name != "posix":
+    print("Checking for sparse files is only supported on POSIX systems, skipping")
+    sys.exit(SKIP)
+
+assert not os.path.exists(prelude.dldi_sd_card_path), f"{prelude.dldi_sd_card_path} shouldn't exist yet"
+
+with prelude.session() as session:
+    skipped_zero_bytes = session.get_proc_address("melondsds_file_skipped_zero_bytes", CFUNCTYPE(c_uint64))
+    assert skipped_zero_bytes is not None, "melondsds_file_skipped_zero_bytes not found"
+
+    for i in range(FRAMES):
+        session.run()
+
+    skipped = skipped_zero_bytes()
+
+assert os.path.isfile(prelude.dldi_sd_card_path), f"{prelude.dldi_sd_card_path} should exist after the session"
+st = os.stat(prelude.dldi_sd_card_path)
+allocated = st.st_blocks * 512
+
+print(f"Skipped writing {skipped} zero bytes")
+print(f"SD card image is {st.st_size} bytes, of which {allocated} are allocated on disk")
+assert skipped > 0, "Creating a new SD card image should have skipped writing some zeroes"
+assert allocated < st.st_size, "The SD card image should be a sparse file"
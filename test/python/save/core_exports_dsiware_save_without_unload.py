@@ -0,0 +1,48 @@
+import os
+import signal
+import sys
+from ctypes import CFUNCTYPE, c_bool, c_uint8
+
+import prelude
+
+MARKER = 0xA5
+# More than the core's 120-frame flush delay
+FRAMES_AFTER_SAVE = 300
+SKIPPED = 77
+
+content_name = os.path.splitext(os.path.basename(prelude.content_path))[0]
+save_path = os.path.join(prelude.save_dir, f"{content_name}.public.sav".encode())
+
+pid = os.fork()
+if pid == 0:
+    # The child plays the game, then dies without unloading it (as if it had crashed)
+    with prelude.session() as session:
+        fill_public_save = session.get_proc_address("melondsds_dsiware_fill_public_save", CFUNCTYPE(c_bool, c_uint8))
+        assert fill_public_save is not None, "melondsds_dsiware_fill_public_save not found"
+
+        for i in range(60):
+            session.run()
+
+        if not fill_public_save(MARKER):
+            print("The test DSiWare title doesn't use public save data")
+            sys.stdout.flush()
+            os._exit(SKIPPED)
+
+        for i in range(FRAMES_AFTER_SAVE):
+            session.run()
+
+        sys.stdout.flush()
+        os.kill(os.getpid(), signal.SIGKILL)
+
+_, status = os.waitpid(pid, 0)
+if os.WIFEXITED(status) and os.WEXITSTATUS(status) == SKIPPED:
+    sys.exit(SKIPPED)
+
+assert os.WIFSIGNALED(status) and os.WTERMSIG(status) == signal.SIGKILL, f"Expected the session to be killed, got status {status}"
+assert os.path.isfile(save_path), f"Expected the save data to be exported to {save_path} before the session ended"
+
+with open(save_path, "rb") as f:
+    data = f.read()
+
+print(f"Found {len(data)} bytes of exported save data at {save_path}")
+assert data and all(b == MARKER for b in data), "The exported save data isn't what the game last saved"
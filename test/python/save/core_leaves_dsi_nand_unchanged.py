@@ -0,0 +1,39 @@
+import hashlib
+import os
+import stat
+from ctypes import CFUNCTYPE, c_uint64
+
+import prelude
+
+nand_path = os.path.join(prelude.core_system_dir, os.path.basename(os.environ["DSI_NAND"]).encode())
+
+
+def hash_file(path: bytes) -> str:
+    digest = hashlib.sha256()
+    with open(path, "rb") as f:
+        while chunk := f.read(1024 * 1024):
+            digest.update(chunk)
+    return digest.hexdigest()
+
+
+original_hash = hash_file(nand_path)
+original_mode = os.stat(nand_path).st_mode
+
+# The NAND should only ever be opened read-only during a DSiWare session
+os.chmod(nand_path, stat.S_IRUSR | stat.S_IRGRP | stat.S_IROTH)
+
+try:
+    with prelude.session() as session:
+        overlay_sectors = session.get_proc_address("melondsds_file_overlay_sectors", CFUNCTYPE(c_uint64))
+        assert overlay_sectors is not None, "melondsds_file_overlay_sectors not found"
+
+        for i in range(300):
+            session.run()
+
+        sectors = overlay_sectors()
+finally:
+    os.chmod(nand_path, original_mode)
+
+print(f"Kept {sectors} changed NAND sectors in memory")
+assert sectors > 0, "Installing the DSiWare title should have changed some NAND sectors"
+assert hash_file(nand_path) == original_hash, "The DSi NAND image shouldn't change during a DSiWare session"
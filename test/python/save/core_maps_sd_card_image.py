@@ -0,0 +1,32 @@
+import os
+import sys
+from ctypes import CFUNCTYPE, c_uint64
+
+import prelude
+
+SKIP = 77
+FRAMES = 120
+
+if os.name != "posix":
+    print("Memory-mapped disk images are only supported on POSIX systems, skipping")
+    sys.exit(SKIP)
+
+# The first session creates the SD card image through the VFS...
+with prelude.session() as session:
+    for i in range(FRAMES):
+        session.run()
+
+assert os.path.isfile(prelude.dldi_sd_card_path), f"{prelude.dldi_sd_card_path} should exist after the first session"
+
+# ...and the second one should map it, since it's now a regular local file
+with prelude.session() as session:
+    mapped_files = session.get_proc_address("melondsds_file_mapped_files", CFUNCTYPE(c_uint64))
+    assert mapped_files is not None, "melondsds_file_mapped_files not found"
+
+    for i in range(FRAMES):
+        session.run()
+
+    mapped = mapped_files()
+
+print(f"Mapped {mapped} files")
+assert mapped > 0, "Expected the SD card image to be memory-mapped"